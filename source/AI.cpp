@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Gamerules.h"
 #include "Government.h"
 #include "Hardpoint.h"
+#include "InterceptSolver.h"
 #include "JumpTypes.h"
 #include "Mask.h"
 #include "Messages.h"
@@ -33,6 +34,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Point.h"
 #include "Preferences.h"
 #include "Random.h"
+#include "RouteCache.h"
 #include "Ship.h"
 #include "ship/ShipAICache.h"
 #include "ShipEvent.h"
@@ -45,6 +47,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <numeric>
 #include <set>
 
 using namespace std;
@@ -231,9 +234,9 @@ namespace {
 		const System *from = ship.GetSystem();
 		if(from == targetSystem || !targetSystem)
 			return;
-		const DistanceMap route(ship, targetSystem);
-		const bool needsRefuel = ShouldRefuel(ship, route);
-		const System *to = route.Route(from);
+		const shared_ptr<const DistanceMap> route = RouteCache::Get(ship, targetSystem);
+		const bool needsRefuel = ShouldRefuel(ship, *route);
+		const System *to = route->Route(from);
 		// The destination may be accessible by both jump and wormhole.
 		// Prefer wormhole travel in these cases, to conserve fuel. Must
 		// check accessibility as DistanceMap may only see the jump path.
@@ -333,6 +336,17 @@ namespace {
 
 	// The minimum speed advantage a ship has to have to consider running away.
 	const double SAFETY_MULTIPLIER = 1.1;
+
+	// The size of the cells of each government's ship grid (as a power of two)
+	// and the number of cells along each side. Target searches cover thousands
+	// of pixels, so the cells are larger than those of the collision sets.
+	const unsigned GRID_SHIFT = 10;
+	const unsigned GRID_CELLS = 64;
+	const unsigned GRID_WRAP_MASK = GRID_CELLS - 1;
+
+	// The most that the preferences in FindTarget() can reduce a foe's
+	// estimated range by.
+	const double MAX_TARGET_PREFERENCE = 3500.;
 }
 
 
@@ -554,7 +568,7 @@ void AI::ClearOrders()
 
 
 
-void AI::Step(const PlayerInfo &player, Command &activeCommands)
+void AI::Step(const PlayerInfo &player, Command &activeCommands, const ForEach &forEach)
 {
 	// First, figure out the comparative strengths of the present governments.
 	const System *playerSystem = player.GetSystem();
@@ -585,6 +599,9 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 
 	const Ship *flagship = player.Flagship();
 	step = (step + 1) & 31;
+	scheduler.BeginStep(playerSystem, flagship ? flagship->Position() : Point());
+	PrepareFiring(flagship, playerSystem, forEach);
+	auto prepared = firing.begin();
 	int targetTurn = 0;
 	int minerCount = 0;
 	const int maxMinerCount = minables.empty() ? 0 : 9;
@@ -593,6 +610,7 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 	const int npcMaxMiningTime = GameData::GetGamerules().NPCMaxMiningTime();
 	for(const auto &it : ships)
 	{
+		const Firing &preparedFiring = *prepared++;
 		// A destroyed ship can't do anything.
 		if(it->IsDestroyed())
 			continue;
@@ -688,20 +706,45 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 			// Each ship only switches targets twice a second, so that it can
 			// focus on damaging one particular ship.
 			targetTurn = (targetTurn + 1) & 31;
-			if(targetTurn == step || !target || target->IsDestroyed() || (target->IsDisabled() && personality.Disables())
-					|| (target->IsFleeing() && personality.IsMerciful()) || !target->IsTargetable())
+			bool isTargetInvalid = !target || target->IsDestroyed() || !target->IsTargetable();
+			bool needsTarget = isTargetInvalid || (target->IsDisabled() && personality.Disables())
+					|| (target->IsFleeing() && personality.IsMerciful());
+			if(targetTurn == step || needsTarget)
 			{
-				target = FindTarget(*it);
-				it->SetTargetShip(target);
+				if(scheduler.Allow(*it, DecisionScheduler::FIND_TARGET, needsTarget))
+				{
+					target = FindTarget(*it);
+					it->SetTargetShip(target);
+				}
+				// If the search has to wait, stop pursuing a target that is gone.
+				else if(target && isTargetInvalid)
+				{
+					target.reset();
+					it->SetTargetShip(target);
+				}
 			}
 		}
 		if(isPresent)
 		{
-			AimTurrets(*it, firingCommands, it->IsYours() ? opportunisticEscorts : personality.IsOpportunistic());
-			if(targetAsteroid)
-				AutoFire(*it, firingCommands, *targetAsteroid);
+			// Use the firing commands that were worked out at the start of this
+			// step, unless this ship has picked a new target or been given new
+			// orders since then.
+			if(preparedFiring.isValid && preparedFiring.inputs == GetFiringInputs(*it))
+			{
+				firingCommands.UpdateWith(preparedFiring.command);
+				// The random sweep of idle turrets is left until now, so that
+				// it draws from the random number generator in a fixed order.
+				if(preparedFiring.isSweeping)
+					SweepTurrets(*it, firingCommands);
+			}
 			else
-				AutoFire(*it, firingCommands);
+			{
+				AimTurrets(*it, firingCommands, it->IsYours() ? opportunisticEscorts : personality.IsOpportunistic());
+				if(targetAsteroid)
+					AutoFire(*it, firingCommands, *targetAsteroid);
+				else
+					AutoFire(*it, firingCommands);
+			}
 		}
 
 		// If this ship is hyperspacing, or in the act of
@@ -1079,6 +1122,22 @@ void AI::Step(const PlayerInfo &player, Command &activeCommands)
 
 
 
+// Get the fraction of checks of whether a weapon would hit a target that were
+// answered by reusing a recent answer, and the number of checks.
+double AI::FiringCacheHitRate() const
+{
+	return firingCacheLookups ? static_cast<double>(firingCacheHits) / firingCacheLookups : 0.;
+}
+
+
+
+uint64_t AI::FiringCacheLookups() const
+{
+	return firingCacheLookups;
+}
+
+
+
 void AI::SetMousePosition(Point position)
 {
 	mousePosition = position;
@@ -1159,7 +1218,7 @@ void AI::AskForHelp(Ship &ship, bool &isStranded, const Ship *flagship)
 {
 	if(HasHelper(ship, isStranded))
 		isStranded = true;
-	else if(!Random::Int(30))
+	else if(!Random::Int(30) && scheduler.Allow(ship, DecisionScheduler::ASK_FOR_HELP))
 	{
 		const Government *gov = ship.GetGovernment();
 		bool hasEnemy = false;
@@ -1336,8 +1395,15 @@ shared_ptr<Ship> AI::FindTarget(const Ship &ship) const
 	if(!person.IsDaring() && strengthIt != shipStrength.end())
 		maxStrength = 2 * strengthIt->second;
 
-	// Get a list of all targetable, hostile ships in this system.
-	const auto enemies = GetShipsList(ship, true);
+	// Get a list of all targetable, hostile ships in this system. Unless every
+	// foe may be chosen, only those that are close enough now to be preferred
+	// over having no target need to be considered, allowing for how far this
+	// ship and each foe may move before the range to them is estimated.
+	double searchRange = -1.;
+	if(!person.IsNemesis() && closest < numeric_limits<double>::infinity())
+		searchRange = closest + MAX_TARGET_PREFERENCE + 1.
+			+ 60. * (ship.Velocity().Length() + maxShipSpeed);
+	const auto enemies = GetShipsList(ship, true, searchRange);
 	for(const auto &foe : enemies)
 	{
 		// If this is a "nemesis" ship and it has found one of the player's
@@ -1424,7 +1490,6 @@ shared_ptr<Ship> AI::FindNonHostileTarget(const Ship &ship) const
 	bool outfitScan = ship.Attributes().Get("outfit scan power");
 	if(cargoScan || outfitScan)
 	{
-		const auto allies = GetShipsList(ship, false);
 		// If this ship already has a target, and is in the process of scanning it, prioritise that.
 		shared_ptr<Ship> oldTarget = ship.GetTargetShip();
 		if(oldTarget && !oldTarget->IsTargetable())
@@ -1436,8 +1501,10 @@ shared_ptr<Ship> AI::FindNonHostileTarget(const Ship &ship) const
 			if(cargoScanInProgress || outfitScanInProgress)
 				target = std::move(oldTarget);
 		}
-		else
+		// Looking through all the other ships for one to scan can wait.
+		else if(scheduler.Allow(ship, DecisionScheduler::FIND_NON_HOSTILE_TARGET))
 		{
+			const auto allies = GetShipsList(ship, false);
 			double closest = numeric_limits<double>::infinity();
 			const Government *gov = ship.GetGovernment();
 			for(const auto &it : allies)
@@ -1474,23 +1541,34 @@ vector<Ship *> AI::GetShipsList(const Ship &ship, bool targetEnemies, double max
 
 	auto targets = vector<Ship *>();
 
-	// The cached lists are built each step based on the current ships in the player's system.
-	const auto &rosters = targetEnemies ? enemyLists : allyLists;
+	// The cached grids are built each step based on the current ships in the player's system.
+	const auto &relations = targetEnemies ? enemyGovernments : allyGovernments;
 
-	const auto it = rosters.find(ship.GetGovernment());
-	if(it != rosters.end() && !it->second.empty())
+	const auto it = relations.find(ship.GetGovernment());
+	if(it != relations.end())
 	{
-		targets.reserve(it->second.size());
-
 		const System *here = ship.GetSystem();
 		const Point &p = ship.Position();
-		for(const auto &target : it->second)
-			if(target->IsTargetable() && target->GetSystem() == here
-					&& !(target->IsHyperspacing() && target->Velocity().Length() > 10.)
-					&& p.Distance(target->Position()) < maxRange
-					&& (ship.IsYours() || !target->GetPersonality().IsMarked())
-					&& (target->IsYours() || !ship.GetPersonality().IsMarked()))
-				targets.emplace_back(target);
+		const bool isLimited = (maxRange < numeric_limits<double>::infinity());
+		vector<Ship *> nearby;
+		for(const Government *gov : it->second)
+		{
+			// If the range is limited, only check ships in the nearby grid cells.
+			const vector<Ship *> *candidates = &governmentRosters.at(gov);
+			if(isLimited)
+			{
+				nearby.clear();
+				shipGrids.at(gov).Find(p, maxRange, nearby);
+				candidates = &nearby;
+			}
+			for(const auto &target : *candidates)
+				if(target->IsTargetable() && target->GetSystem() == here
+						&& !(target->IsHyperspacing() && target->Velocity().Length() > 10.)
+						&& p.Distance(target->Position()) < maxRange
+						&& (ship.IsYours() || !target->GetPersonality().IsMarked())
+						&& (target->IsYours() || !ship.GetPersonality().IsMarked()))
+					targets.emplace_back(target);
+		}
 	}
 
 	return targets;
@@ -1679,8 +1757,10 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 	// Ships should choose a random system/planet for travel if they do not
 	// already have a system/planet in mind, and are free to move about.
 	const System *origin = ship.GetSystem();
+	bool hasNewDestination = false;
 	if(!ship.GetTargetSystem() && !ship.GetTargetStellar() && !shouldStay)
 	{
+		hasNewDestination = true;
 		// TODO: This should problably be changed, because JumpsRemaining
 		// does not return an accurate number.
 		int jumps = ship.JumpsRemaining(false);
@@ -1758,8 +1838,10 @@ void AI::MoveIndependent(Ship &ship, Command &command) const
 	}
 	// Choose the best method of reaching the target system, which may mean
 	// using a local wormhole rather than jumping. If this ship has chosen
-	// to land, this decision will not be altered.
-	SelectRoute(ship, ship.GetTargetSystem());
+	// to land, this decision will not be altered. Checking whether a route
+	// that was already chosen is still the best one can wait.
+	if(hasNewDestination || scheduler.Allow(ship, DecisionScheduler::SELECT_ROUTE))
+		SelectRoute(ship, ship.GetTargetSystem());
 
 	if(ship.GetTargetSystem())
 	{
@@ -2803,7 +2885,8 @@ void AI::DoMining(Ship &ship, Command &command)
 	double radius = miningRadius[&ship] * pow(2., angle.Unit().X());
 
 	shared_ptr<Minable> target = ship.GetTargetAsteroid();
-	if(!target || target->Velocity().Length() > ship.MaxVelocity())
+	if((!target || target->Velocity().Length() > ship.MaxVelocity())
+			&& scheduler.Allow(ship, DecisionScheduler::FIND_ASTEROID))
 	{
 		for(const shared_ptr<Minable> &minable : minables)
 		{
@@ -3180,7 +3263,8 @@ Point AI::TargetAim(const Ship &ship, const Body &target)
 
 
 // Aim the given ship's turrets.
-void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic) const
+void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic, InterceptSolver *solver,
+	bool *isSweeping) const
 {
 	// First, get the set of potential hostile ships.
 	auto targets = vector<const Body *>();
@@ -3234,53 +3318,71 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic)
 	}
 	if(targets.empty())
 	{
-		for(const Hardpoint &hardpoint : ship.Weapons())
-			if(hardpoint.CanAim())
-			{
-				// Get the index of this weapon.
-				int index = &hardpoint - &ship.Weapons().front();
-				// First, check if this turret is currently in motion. If not,
-				// it only has a small chance of beginning to move.
-				double previous = ship.FiringCommands().Aim(index);
-				if(!previous && (Random::Int(60)))
-					continue;
-
-				Angle centerAngle = Angle(hardpoint.GetPoint());
-				double bias = (centerAngle - hardpoint.GetAngle()).Degrees() / 180.;
-				double acceleration = Random::Real() - Random::Real() + bias;
-				command.SetAim(index, previous + .1 * acceleration);
-			}
+		if(isSweeping)
+			*isSweeping = true;
+		else
+			SweepTurrets(ship, command);
 		return;
 	}
+	// Find where each target is relative to the given turret, and how fast the
+	// turret's projectiles move relative to the target.
+	auto GetProblem = [&ship](const Hardpoint &hardpoint, const Body &target, Point &p, Point &v, double &vp)
+	{
+		// This is where this projectile fires from. Add some randomness
+		// based on how skilled the pilot is.
+		Point start = ship.Position() + ship.Facing().Rotate(hardpoint.GetPoint());
+		start += ship.GetPersonality().Confusion();
+		// Get this projectile's average velocity.
+		const Weapon *weapon = hardpoint.GetOutfit();
+		vp = weapon->WeightedVelocity() + .5 * weapon->RandomVelocity();
+
+		p = target.Position() - start;
+		v = target.Velocity();
+		// Only take the ship's velocity into account if this weapon
+		// does not have its own acceleration.
+		if(!weapon->Acceleration())
+			v -= ship.Velocity();
+		// By the time this action is performed, the target will
+		// have moved forward one time step.
+		p += v;
+	};
+
+	// Find out how long it would take for each turret's projectiles to reach
+	// each target. All of these are solved as one batch.
+	if(!solver)
+		solver = &interceptSolver;
+	solver->Clear(ship.Weapons().size() * targets.size());
+	Point p;
+	Point v;
+	double vp = 0.;
+	for(const Hardpoint &hardpoint : ship.Weapons())
+		if(hardpoint.CanAim())
+			for(const Body *target : targets)
+			{
+				GetProblem(hardpoint, *target, p, v, vp);
+				solver->Add(p, v, vp);
+			}
+	solver->Solve();
+
 	// Each hardpoint should aim at the target that it is "closest" to hitting.
+	size_t problem = 0;
 	for(const Hardpoint &hardpoint : ship.Weapons())
 		if(hardpoint.CanAim())
 		{
-			// This is where this projectile fires from. Add some randomness
-			// based on how skilled the pilot is.
-			Point start = ship.Position() + ship.Facing().Rotate(hardpoint.GetPoint());
-			start += ship.GetPersonality().Confusion();
 			// Get the turret's current facing, in absolute coordinates:
 			Angle aim = ship.Facing() + hardpoint.GetAngle();
-			// Get this projectile's average velocity.
 			const Weapon *weapon = hardpoint.GetOutfit();
-			double vp = weapon->WeightedVelocity() + .5 * weapon->RandomVelocity();
 			// Loop through each body this hardpoint could shoot at. Find the
 			// one that is the "best" in terms of how many frames it will take
 			// to aim at it and for a projectile to hit it.
 			double bestScore = numeric_limits<double>::infinity();
 			double bestAngle = 0.;
-			for(const Body *target : targets)
+			for(size_t i = 0; i < targets.size(); ++i)
 			{
-				Point p = target->Position() - start;
-				Point v = target->Velocity();
-				// Only take the ship's velocity into account if this weapon
-				// does not have its own acceleration.
-				if(!weapon->Acceleration())
-					v -= ship.Velocity();
-				// By the time this action is performed, the target will
-				// have moved forward one time step.
-				p += v;
+				p = solver->Position(problem);
+				v = solver->Velocity(problem);
+				vp = solver->Speed(problem);
+				double solution = solver->Time(problem++);
 
 				double rendezvousTime = numeric_limits<double>::quiet_NaN();
 				double distance = p.Length();
@@ -3292,7 +3394,7 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic)
 				{
 					// Find out how long it would take for this projectile to reach the target.
 					if(!isInstantaneous)
-						rendezvousTime = RendezvousTime(p, v, vp);
+						rendezvousTime = solution;
 
 					// If there is no intersection (i.e. the turret is not facing the target),
 					// consider this target "out-of-range" but still targetable.
@@ -3329,8 +3431,33 @@ void AI::AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic)
 
 
 
+// Sweep the given ship's turrets back and forth at random, with the sweep
+// centered on the "outward-facing" angle.
+void AI::SweepTurrets(const Ship &ship, FireCommand &command)
+{
+	for(const Hardpoint &hardpoint : ship.Weapons())
+		if(hardpoint.CanAim())
+		{
+			// Get the index of this weapon.
+			int index = &hardpoint - &ship.Weapons().front();
+			// First, check if this turret is currently in motion. If not,
+			// it only has a small chance of beginning to move.
+			double previous = ship.FiringCommands().Aim(index);
+			if(!previous && (Random::Int(60)))
+				continue;
+
+			Angle centerAngle = Angle(hardpoint.GetPoint());
+			double bias = (centerAngle - hardpoint.GetAngle()).Degrees() / 180.;
+			double acceleration = Random::Real() - Random::Real() + bias;
+			command.SetAim(index, previous + .1 * acceleration);
+		}
+}
+
+
+
 // Fire whichever of the given ship's weapons can hit a hostile target.
-void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool isFlagship) const
+void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool isFlagship,
+	FiringCache *cache) const
 {
 	const Personality &person = ship.GetPersonality();
 	if(person.IsPacifist() || ship.CannotAct())
@@ -3520,7 +3647,14 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, bool secondary, bool i
 			v *= lifetime;
 
 			const Mask &mask = target->GetMask(step);
-			if(mask.Collide(-p, v, target->Facing()) < 1.)
+			bool hits = false;
+			if(!cache || !cache->Find(index, *target, mask, p, v, hits))
+			{
+				hits = (mask.Collide(-p, v, target->Facing()) < 1.);
+				if(cache)
+					cache->Store(index, *target, mask, p, v, hits);
+			}
+			if(hits)
 			{
 				command.SetFire(index);
 				break;
@@ -3573,40 +3707,118 @@ void AI::AutoFire(const Ship &ship, FireCommand &command, const Body &target) co
 
 
 
+// Work out the turret aim and automatic fire of every ship that may need them
+// this step, as long as each ship keeps its current targets.
+void AI::PrepareFiring(const Ship *flagship, const System *playerSystem, const ForEach &forEach)
+{
+	// Checking whether a weapon can hit a target uses the target's collision
+	// mask, so bring every mask up to date for this step first.
+	firing.resize(ships.size());
+	auto slot = firing.begin();
+	for(const auto &it : ships)
+	{
+		it->GetMask(step);
+		slot->ship = it.get();
+		// Create each ship's cache of firing solutions here, so that each ship
+		// only accesses its own cache below.
+		FiringCache &cache = firingCaches[it.get()];
+		firingCacheLookups += cache.Lookups();
+		firingCacheHits += cache.Hits();
+		cache.ResetCounts();
+		cache.BeginStep();
+		(slot++)->cache = &cache;
+	}
+	// Forget the caches of any ships that are gone. Every ship in the list has
+	// a cache, so there are other caches only if the counts differ.
+	if(firingCaches.size() > firing.size())
+	{
+		vector<const Ship *> present;
+		present.reserve(firing.size());
+		for(const Firing &it : firing)
+			present.push_back(it.ship);
+		sort(present.begin(), present.end());
+		for(auto it = firingCaches.begin(); it != firingCaches.end(); )
+		{
+			if(binary_search(present.begin(), present.end(), it->first))
+				++it;
+			else
+			{
+				firingCacheLookups += it->second.Lookups();
+				firingCacheHits += it->second.Hits();
+				it = firingCaches.erase(it);
+			}
+		}
+	}
+	for(const auto &it : minables)
+		it->GetMask(step);
+
+	bool opportunisticEscorts = !Preferences::Has("Turrets focus fire");
+	forEach(firing.size(), [this, flagship, playerSystem, opportunisticEscorts](size_t i)
+	{
+		// Only ships that are in the player's system and able to act aim and
+		// fire automatically.
+		Firing &result = firing[i];
+		const Ship &ship = *result.ship;
+		result.isValid = (ship.GetSystem() && ship.GetSystem() == playerSystem && &ship != flagship
+			&& !ship.IsDestroyed() && !ship.IsDisabled() && !ship.IsOverheated());
+		if(!result.isValid)
+			return;
+
+		shared_ptr<Minable> targetAsteroid = ship.GetTargetAsteroid();
+		result.inputs = GetFiringInputs(ship);
+		result.command.SetHardpoints(ship.Weapons().size());
+		bool opportunistic = ship.IsYours() ? opportunisticEscorts : ship.GetPersonality().IsOpportunistic();
+		result.isSweeping = false;
+		AimTurrets(ship, result.command, opportunistic, &result.solver, &result.isSweeping);
+		if(targetAsteroid)
+			AutoFire(ship, result.command, *targetAsteroid);
+		else
+			AutoFire(ship, result.command, true, false, result.cache);
+	});
+}
+
+
+
+// Get everything about the given ship, other than its position and that of
+// the ships around it, that AutoFire() depends on.
+AI::FiringInputs AI::GetFiringInputs(const Ship &ship) const
+{
+	FiringInputs inputs;
+	shared_ptr<Ship> target = ship.GetTargetShip();
+	inputs.target = target.get();
+	inputs.targetAsteroid = ship.GetTargetAsteroid().get();
+	inputs.targetIsEnemy = target && target->GetGovernment()->IsEnemy(ship.GetGovernment());
+	if(ship.IsYours())
+	{
+		auto it = orders.find(&ship);
+		if(it != orders.end())
+		{
+			inputs.orderType = it->second.type;
+			inputs.orderTarget = it->second.target.lock().get();
+		}
+	}
+	inputs.isWaitingToJump = ship.Commands().Has(Command::JUMP | Command::WAIT);
+	return inputs;
+}
+
+
+
+bool AI::FiringInputs::operator==(const FiringInputs &other) const
+{
+	return target == other.target && targetAsteroid == other.targetAsteroid
+		&& targetIsEnemy == other.targetIsEnemy && orderType == other.orderType
+		&& orderTarget == other.orderTarget && isWaitingToJump == other.isWaitingToJump;
+}
+
+
+
 // Get the amount of time it would take the given weapon to reach the given
 // target, assuming it can be fired in any direction (i.e. turreted). For
 // non-turreted weapons this can be used to calculate the ideal direction to
 // point the ship in.
 double AI::RendezvousTime(const Point &p, const Point &v, double vp)
 {
-	// How many steps will it take this projectile
-	// to intersect the target?
-	// (p.x + v.x*t)^2 + (p.y + v.y*t)^2 = vp^2*t^2
-	// p.x^2 + 2*p.x*v.x*t + v.x^2*t^2
-	//    + p.y^2 + 2*p.y*v.y*t + v.y^2t^2
-	//    - vp^2*t^2 = 0
-	// (v.x^2 + v.y^2 - vp^2) * t^2
-	//    + (2 * (p.x * v.x + p.y * v.y)) * t
-	//    + (p.x^2 + p.y^2) = 0
-	double a = v.Dot(v) - vp * vp;
-	double b = 2. * p.Dot(v);
-	double c = p.Dot(p);
-	double discriminant = b * b - 4 * a * c;
-	if(discriminant < 0.)
-		return numeric_limits<double>::quiet_NaN();
-
-	discriminant = sqrt(discriminant);
-
-	// The solutions are b +- discriminant.
-	// But it's not a solution if it's negative.
-	double r1 = (-b + discriminant) / (2. * a);
-	double r2 = (-b - discriminant) / (2. * a);
-	if(r1 >= 0. && r2 >= 0.)
-		return min(r1, r2);
-	else if(r1 >= 0. || r2 >= 0.)
-		return max(r1, r2);
-
-	return numeric_limits<double>::quiet_NaN();
+	return InterceptSolver::Time(p, v, vp);
 }
 
 
@@ -4397,21 +4609,89 @@ void AI::UpdateStrengths(map<const Government *, int64_t> &strength, const Syste
 // Cache various lists of all targetable ships in the player's system for this Step.
 void AI::CacheShipLists()
 {
-	allyLists.clear();
-	enemyLists.clear();
+	allyGovernments.clear();
+	enemyGovernments.clear();
+	shipGrids.clear();
+	maxShipSpeed = 0.;
 	for(const auto &git : governmentRosters)
 	{
-		allyLists.emplace(git.first, vector<Ship *>());
-		allyLists.at(git.first).reserve(ships.size());
-		enemyLists.emplace(git.first, vector<Ship *>());
-		enemyLists.at(git.first).reserve(ships.size());
+		auto &allies = allyGovernments[git.first];
+		auto &enemies = enemyGovernments[git.first];
 		for(const auto &oit : governmentRosters)
+			(git.first->IsEnemy(oit.first) ? enemies : allies).push_back(oit.first);
+
+		shipGrids[git.first].Build(git.second);
+		for(const Ship *ship : git.second)
+			maxShipSpeed = max(maxShipSpeed, ship->Velocity().Length());
+	}
+}
+
+
+
+// Clear the grid, and sort the given ships into it.
+void AI::ShipGrid::Build(const vector<Ship *> &ships)
+{
+	this->ships = ships;
+	counts.assign(GRID_CELLS * GRID_CELLS + 1, 0);
+
+	// Count the ships in each cell, then perform a radix sort.
+	vector<Entry> added;
+	added.reserve(ships.size());
+	for(unsigned i = 0; i < ships.size(); ++i)
+	{
+		const Point &position = ships[i]->Position();
+		added.emplace_back(i, static_cast<int>(position.X()) >> GRID_SHIFT,
+			static_cast<int>(position.Y()) >> GRID_SHIFT);
+		const Entry &entry = added.back();
+		++counts[(entry.y & GRID_WRAP_MASK) * GRID_CELLS + (entry.x & GRID_WRAP_MASK) + 1];
+	}
+	partial_sum(counts.begin(), counts.end(), counts.begin());
+
+	sorted.resize(added.size());
+	for(const Entry &entry : added)
+		sorted[counts[(entry.y & GRID_WRAP_MASK) * GRID_CELLS + (entry.x & GRID_WRAP_MASK)]++] = entry;
+	// Each count has now been advanced to the end of its cell, which is where
+	// the next cell begins. Shift them back so that counts[i] is where cell i begins.
+	copy_backward(counts.begin(), counts.end() - 1, counts.end());
+	counts.front() = 0;
+}
+
+
+
+// Add each ship that may be within the given range of the given point to the
+// list, in the same order as they were given to Build().
+void AI::ShipGrid::Find(const Point &center, double range, vector<Ship *> &result) const
+{
+	// If the range covers the whole grid, every ship may be within it.
+	if(range >= (GRID_CELLS << GRID_SHIFT) / 2)
+	{
+		result.insert(result.end(), ships.begin(), ships.end());
+		return;
+	}
+
+	const int minX = static_cast<int>(center.X() - range) >> GRID_SHIFT;
+	const int minY = static_cast<int>(center.Y() - range) >> GRID_SHIFT;
+	const int maxX = static_cast<int>(center.X() + range) >> GRID_SHIFT;
+	const int maxY = static_cast<int>(center.Y() + range) >> GRID_SHIFT;
+
+	vector<unsigned> indices;
+	for(int y = minY; y <= maxY; ++y)
+		for(int x = minX; x <= maxX; ++x)
 		{
-			auto &list = git.first->IsEnemy(oit.first)
-					? enemyLists[git.first] : allyLists[git.first];
-			list.insert(list.end(), oit.second.begin(), oit.second.end());
+			const unsigned index = (y & GRID_WRAP_MASK) * GRID_CELLS + (x & GRID_WRAP_MASK);
+			for(unsigned i = counts[index]; i < counts[index + 1]; ++i)
+			{
+				// Skip ships that are in this cell only because of the cell
+				// coordinates wrapping around.
+				const Entry &entry = sorted[i];
+				if(entry.x == x && entry.y == y)
+					indices.push_back(entry.index);
+			}
 		}
-	}
+
+	sort(indices.begin(), indices.end());
+	for(unsigned index : indices)
+		result.push_back(ships[index]);
 }
 
 
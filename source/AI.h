@@ -17,10 +17,15 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #define ES_AI_H_
 
 #include "Command.h"
+#include "DecisionScheduler.h"
 #include "FireCommand.h"
+#include "FiringCache.h"
+#include "InterceptSolver.h"
 #include "Point.h"
 
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -51,6 +56,9 @@ public:
 	// Any object that can be a ship's target is in a list of this type:
 template <class Type>
 	using List = std::list<std::shared_ptr<Type>>;
+	// A function that calls the given function once for each index below the
+	// given count. The calls may be spread across several threads.
+	using ForEach = std::function<void(std::size_t, const std::function<void(std::size_t)> &)>;
 	// Constructor, giving the AI access to various object lists.
 	AI(const List<Ship> &ships, const List<Minable> &minables, const List<Flotsam> &flotsam);
 
@@ -68,8 +76,13 @@ template <class Type>
 	// Clear ship orders. This should be done when the player lands on a planet,
 	// but not when they jump from one system to another.
 	void ClearOrders();
-	// Issue AI commands to all ships for one game step.
-	void Step(const PlayerInfo &player, Command &activeCommands);
+	// Issue AI commands to all ships for one game step. The given function is
+	// used for the parts of the step that each ship can do independently.
+	void Step(const PlayerInfo &player, Command &activeCommands, const ForEach &forEach);
+	// Get the fraction of checks of whether a weapon would hit a target that
+	// were answered by reusing a recent answer, and the number of checks.
+	double FiringCacheHitRate() const;
+	uint64_t FiringCacheLookups() const;
 
 	// Set the mouse position for turning the player's flagship.
 	void SetMousePosition(Point position);
@@ -140,12 +153,25 @@ private:
 	// returns the direction to the target.
 	static Point TargetAim(const Ship &ship);
 	static Point TargetAim(const Ship &ship, const Body &target);
-	// Aim the given ship's turrets.
-	void AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic = false) const;
+	// Aim the given ship's turrets. The intercept problems are worked out with
+	// the given solver, or with this AI's own solver if none is given. If
+	// isSweeping is given, opportunistic turrets with nothing to aim at are left
+	// alone, and it is set to true so the caller can sweep them later.
+	void AimTurrets(const Ship &ship, FireCommand &command, bool opportunistic = false,
+		InterceptSolver *solver = nullptr, bool *isSweeping = nullptr) const;
+	// Sweep the given ship's turrets back and forth at random.
+	static void SweepTurrets(const Ship &ship, FireCommand &command);
 	// Fire whichever of the given ship's weapons can hit a hostile target.
 	// Return a bitmask giving the weapons to fire.
-	void AutoFire(const Ship &ship, FireCommand &command, bool secondary = true, bool isFlagship = false) const;
+	// If a cache is given, recent answers to whether a weapon would hit a
+	// target are reused.
+	void AutoFire(const Ship &ship, FireCommand &command, bool secondary = true, bool isFlagship = false,
+		FiringCache *cache = nullptr) const;
 	void AutoFire(const Ship &ship, FireCommand &command, const Body &target) const;
+	// Work out the turret aim and automatic fire of every ship that may need
+	// them this step. This only reads the state of the ships, so each ship can
+	// be handled independently.
+	void PrepareFiring(const Ship *flagship, const System *playerSystem, const ForEach &forEach);
 
 	// Calculate how long it will take a projectile to reach a target given the
 	// target's relative position and velocity and the velocity of the
@@ -197,11 +223,79 @@ private:
 		const System *targetSystem = nullptr;
 	};
 
+	// Everything about a ship, other than the positions of it and the ships
+	// around it, that decides which of its weapons fire automatically.
+	class FiringInputs {
+	public:
+		bool operator==(const FiringInputs &other) const;
+		bool operator!=(const FiringInputs &other) const { return !(*this == other); }
+
+		const Ship *target = nullptr;
+		const Minable *targetAsteroid = nullptr;
+		// Whether the target was an enemy.
+		bool targetIsEnemy = false;
+		// The player's orders to this ship, if any.
+		int orderType = -1;
+		const Ship *orderTarget = nullptr;
+		// Whether this ship was preparing to jump.
+		bool isWaitingToJump = false;
+	};
+
+	// The turret aim and automatic fire worked out for one ship at the start
+	// of a step, before any ship has changed its target.
+	class Firing {
+	public:
+		const Ship *ship = nullptr;
+		FireCommand command;
+		// The inputs that the command was worked out for. If any of them change
+		// before the ship's turn, the command must be worked out again.
+		FiringInputs inputs;
+		// This ship's recent firing solutions.
+		FiringCache *cache = nullptr;
+		bool isValid = false;
+		// Whether this ship's turrets had nothing to aim at, and should sweep
+		// at random once the command is used.
+		bool isSweeping = false;
+		// Storage for aiming this ship's turrets, which is kept from step to
+		// step so that it need not be allocated again.
+		InterceptSolver solver;
+	};
+
+	// The ships of one government, sorted into a grid keyed the same way as a
+	// CollisionSet, so that the ships near a point can be found quickly.
+	class ShipGrid {
+	public:
+		// Clear the grid, and sort the given ships into it.
+		void Build(const std::vector<Ship *> &ships);
+		// Add each ship that may be within the given range of the given point
+		// to the list, in the same order as they were given to Build().
+		void Find(const Point &center, double range, std::vector<Ship *> &result) const;
+
+	private:
+		class Entry {
+		public:
+			Entry() = default;
+			Entry(unsigned index, int x, int y) : index(index), x(x), y(y) {}
+
+			unsigned index;
+			int x;
+			int y;
+		};
+
+	private:
+		std::vector<Ship *> ships;
+		// The ships, sorted by grid cell. Cell i begins at counts[i].
+		std::vector<Entry> sorted;
+		std::vector<unsigned> counts;
+	};
+
 
 private:
 	void IssueOrders(const PlayerInfo &player, const Orders &newOrders, const std::string &description);
 	// Convert order types based on fulfillment status.
 	void UpdateOrders(const Ship &ship);
+	// Get the inputs to AutoFire() that may change during a step.
+	FiringInputs GetFiringInputs(const Ship &ship) const;
 
 
 private:
@@ -222,6 +316,20 @@ private:
 	// thrashing the heap, since we can reuse the storage for
 	// each ship.
 	FireCommand firingCommands;
+	// The firing commands worked out for each ship, in the same order as the
+	// ships list.
+	std::vector<Firing> firing;
+	// Each ship's recent answers to whether its weapons would hit nearby
+	// targets, and how often those answers were reused.
+	std::map<const Ship *, FiringCache> firingCaches;
+	uint64_t firingCacheLookups = 0;
+	uint64_t firingCacheHits = 0;
+	// Storage for aiming turrets outside of PrepareFiring(). Only the thread
+	// that calls Step() uses it.
+	mutable InterceptSolver interceptSolver;
+	// Limits the time spent each step on the most expensive decisions. Choosing
+	// a route is one of them, and is done by const functions, so this is mutable.
+	mutable DecisionScheduler scheduler;
 
 	bool isCloaking = false;
 
@@ -256,8 +364,14 @@ private:
 	std::map<const Government *, int64_t> enemyStrength;
 	std::map<const Government *, int64_t> allyStrength;
 	std::map<const Government *, std::vector<Ship *>> governmentRosters;
-	std::map<const Government *, std::vector<Ship *>> enemyLists;
-	std::map<const Government *, std::vector<Ship *>> allyLists;
+	// For each government, the governments whose ships it treats as enemies
+	// or as allies.
+	std::map<const Government *, std::vector<const Government *>> enemyGovernments;
+	std::map<const Government *, std::vector<const Government *>> allyGovernments;
+	// The ships of each government in the player's system, and the speed of
+	// the fastest of them.
+	std::map<const Government *, ShipGrid> shipGrids;
+	double maxShipSpeed = 0.;
 };
 
 
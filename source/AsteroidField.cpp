@@ -50,6 +50,9 @@ void AsteroidField::Clear()
 {
 	asteroids.clear();
 	minables.clear();
+	minableHandles.clear();
+	asteroidCollisions.Clear(0);
+	minableCollisions.Clear(0);
 }
 
 
@@ -60,6 +63,10 @@ void AsteroidField::Add(const string &name, int count, double energy)
 	const Sprite *sprite = SpriteSet::Get("asteroid/" + name + "/spin");
 	for(int i = 0; i < count; ++i)
 		asteroids.emplace_back(sprite, energy);
+
+	// Adding asteroids may have moved the existing ones in memory, so they must
+	// all be inserted into the collision set again.
+	asteroidCollisions.Clear(0);
 }
 
 
@@ -75,6 +82,7 @@ void AsteroidField::Add(const Minable *minable, int count, double energy, const
 	{
 		minables.emplace_back(new Minable(*minable));
 		minables.back()->Place(energy, belts.Get());
+		minableHandles.push_back(minableCollisions.Insert(*minables.back()));
 	}
 }
 
@@ -83,29 +91,35 @@ void AsteroidField::Add(const Minable *minable, int count, double energy, const
 // Move all the asteroids forward one step.
 void AsteroidField::Step(vector<Visual> &visuals, list<shared_ptr<Flotsam>> &flotsam, int step)
 {
-	asteroidCollisions.Clear(step);
+	// The asteroids stay in their collision set from one step to the next, so
+	// only those that have moved into different grid cells need to be
+	// re-sorted. The set holds their positions from before this step.
+	if(asteroidCollisions.All().empty())
+		for(Asteroid &asteroid : asteroids)
+			asteroidCollisions.Insert(asteroid);
+	asteroidCollisions.Update(step);
 	for(Asteroid &asteroid : asteroids)
-	{
-		asteroidCollisions.Add(asteroid);
 		asteroid.Step();
-	}
-	asteroidCollisions.Finish();
 
 	// Step through the minables. Since they are destructible, we may need to
 	// remove them from the list.
-	minableCollisions.Clear(step);
 	auto it = minables.begin();
+	auto handle = minableHandles.begin();
 	while(it != minables.end())
 	{
 		if((*it)->Move(visuals, flotsam))
 		{
-			minableCollisions.Add(**it);
 			++it;
+			++handle;
 		}
 		else
+		{
+			minableCollisions.Remove(*handle);
 			it = minables.erase(it);
+			handle = minableHandles.erase(handle);
+		}
 	}
-	minableCollisions.Finish();
+	minableCollisions.Update(step);
 }
 
 
@@ -122,7 +136,7 @@ void AsteroidField::Draw(DrawList &draw, const Point &center, double zoom) const
 
 
 // Check if the given projectile collides with any asteroids.
-Body *AsteroidField::Collide(const Projectile &projectile, double *closestHit)
+Body *AsteroidField::Collide(const Projectile &projectile, double *closestHit, Minable **minable) const
 {
 	Body *hit = nullptr;
 
@@ -160,7 +174,8 @@ Body *AsteroidField::Collide(const Projectile &projectile, double *closestHit)
 	if(body)
 	{
 		hit = body;
-		reinterpret_cast<Minable *>(body)->TakeDamage(projectile);
+		if(minable)
+			*minable = reinterpret_cast<Minable *>(body);
 	}
 	return hit;
 }
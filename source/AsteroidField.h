@@ -59,8 +59,10 @@ public:
 	// Draw the asteroid field, with the field of view centered on the given point.
 	void Draw(DrawList &draw, const Point &center, double zoom) const;
 	// Check if the given projectile has hit any of the asteroids, using the information
-	// in the collision sets. If a collision occurs, returns a pointer to the hit body.
-	Body *Collide(const Projectile &projectile, double *closestHit);
+	// in the collision sets. If a collision occurs, returns a pointer to the hit body,
+	// and if that body is a minable asteroid, also stores it in the given pointer.
+	// Nothing is damaged, so several threads may check for collisions at once.
+	Body *Collide(const Projectile &projectile, double *closestHit, Minable **minable = nullptr) const;
 
 	// Get the list of minable asteroids.
 	const std::list<std::shared_ptr<Minable>> &Minables() const;
@@ -85,6 +87,9 @@ private:
 private:
 	std::vector<Asteroid> asteroids;
 	std::list<std::shared_ptr<Minable>> minables;
+	// The handle of each minable in the minable collision set, in the same
+	// order as the list of minables.
+	std::list<unsigned> minableHandles;
 
 	CollisionSet asteroidCollisions;
 	CollisionSet minableCollisions;
@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Point.h"
 #include "Random.h"
 #include "Sound.h"
+#include "Tracer.h"
 
 #include <AL/al.h>
 #include <AL/alc.h>
@@ -579,6 +580,7 @@ namespace {
 	// Thread entry point for loading sounds.
 	void Load()
 	{
+		Tracer::SetThreadName("sound loader");
 		string name;
 		string path;
 		Sound *sound;
@@ -602,6 +604,7 @@ namespace {
 			}
 
 			// Unlock the mutex for the time-intensive part of the loop.
+			Tracer::Zone zone("Sound::Load");
 			if(!sound->Load(path, name))
 				Logger::LogError("Unable to load sound \"" + name + "\" from path: " + path);
 		}
@@ -0,0 +1,227 @@
+/* Benchmark.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Benchmark.h"
+
+#include "AI.h"
+#include "Engine.h"
+#include "Files.h"
+#include "GameData.h"
+#include "Logger.h"
+#include "Outfit.h"
+#include "Planet.h"
+#include "PlayerInfo.h"
+#include "Preferences.h"
+#include "Random.h"
+#include "Ship.h"
+#include "ShipEvent.h"
+#include "StepProfile.h"
+#include "System.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// By default, simulate one minute of game time.
+	const int DEFAULT_STEPS = 3600;
+	const uint64_t DEFAULT_SEED = 0;
+
+	// Get the value of the given percentile from a sorted list of step times.
+	double Percentile(const vector<double> &sorted, double percentile)
+	{
+		if(sorted.empty())
+			return 0.;
+		size_t index = static_cast<size_t>(percentile * (sorted.size() - 1) + .5);
+		return sorted[min(index, sorted.size() - 1)];
+	}
+
+	// Read an argument that must consist only of decimal digits. Report an
+	// error if it does not, or if it is too large.
+	bool ParseCount(const string &option, const char *arg, uint64_t maximum, uint64_t &value)
+	{
+		bool isValid = isdigit(static_cast<unsigned char>(*arg));
+		char *end = nullptr;
+		errno = 0;
+		unsigned long long result = strtoull(arg, &end, 10);
+		isValid &= (!*end && errno != ERANGE && result <= maximum);
+		if(isValid)
+			value = result;
+		else
+			Logger::LogError("Benchmark: \"" + option + "\" requires a number from 0 to "
+				+ to_string(maximum) + ", not \"" + arg + "\".");
+		return isValid;
+	}
+}
+
+
+
+bool Benchmark::IsBenchmarkArgument(const char *const *argv)
+{
+	for(const char *const *it = argv + 1; *it; ++it)
+		if(string(*it) == "--benchmark")
+			return true;
+	return false;
+}
+
+
+
+int Benchmark::Run(const char *const *argv)
+{
+	int steps = DEFAULT_STEPS;
+	uint64_t seed = DEFAULT_SEED;
+	string savePath;
+	for(const char *const *it = argv + 1; *it; ++it)
+	{
+		string arg = *it;
+		if(arg == "--steps" && it[1])
+		{
+			uint64_t value = 0;
+			if(!ParseCount(arg, *++it, numeric_limits<int>::max(), value))
+				return 1;
+			steps = max<int>(1, value);
+		}
+		else if(arg == "--seed" && it[1])
+		{
+			if(!ParseCount(arg, *++it, numeric_limits<uint64_t>::max(), seed))
+				return 1;
+		}
+		else if(arg == "--save" && it[1])
+			savePath = *++it;
+	}
+
+	// Sprites are not uploaded, but their dimensions and collision masks are
+	// needed for the simulation to behave as it does in the game.
+	GameData::FinishLoadingSprites();
+	GameData::FinishLoading();
+	Preferences::Load();
+
+	PlayerInfo player;
+	chrono::steady_clock::time_point loadStart = chrono::steady_clock::now();
+	if(savePath.empty())
+		player.LoadRecent();
+	else
+	{
+		if(!Files::Exists(savePath))
+			savePath = Files::Saves() + savePath;
+		if(Files::Exists(savePath))
+			player.Load(savePath);
+	}
+	double loadTime = chrono::duration<double, milli>(chrono::steady_clock::now() - loadStart).count();
+	if(!player.IsLoaded() || !player.Flagship())
+	{
+		Logger::LogError("Benchmark: unable to load a saved game with a flagship.");
+		return 1;
+	}
+
+	// Many derived conditions look up an object by name each time they are
+	// checked, so time checking one for each outfit, system, and planet.
+	vector<string> conditions;
+	for(const auto &it : GameData::Outfits())
+	{
+		conditions.push_back("outfit: " + it.first);
+		conditions.push_back("outfit (all): " + it.first);
+	}
+	for(const auto &it : GameData::Systems())
+		conditions.push_back("visited system: " + it.first);
+	for(const auto &it : GameData::Planets())
+		conditions.push_back("visited planet: " + it.first);
+	chrono::steady_clock::time_point conditionStart = chrono::steady_clock::now();
+	int64_t conditionTotal = 0;
+	for(const string &name : conditions)
+		conditionTotal += player.Conditions().Get(name);
+	double conditionTime = chrono::duration<double, milli>(chrono::steady_clock::now() - conditionStart).count();
+	// Saved games are normally landed, so take off just like the planet panel does.
+	// The saved game itself is never written back.
+	if(player.GetPlanet() && !player.TakeOff(nullptr))
+	{
+		Logger::LogError("Benchmark: the flagship is unable to take off.");
+		return 1;
+	}
+
+	// Seed both the main thread (used when placing ships) and the calculation thread.
+	Random::Seed(seed);
+	Engine engine(player);
+	engine.Seed(seed);
+	engine.Place();
+
+	vector<double> stepTimes;
+	stepTimes.reserve(steps);
+	chrono::steady_clock::time_point start = chrono::steady_clock::now();
+	for(int i = 0; i < steps; ++i)
+	{
+		chrono::steady_clock::time_point stepStart = chrono::steady_clock::now();
+		engine.Go();
+		engine.Wait();
+		stepTimes.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - stepStart).count());
+
+		// Do the work that MainPanel would do between steps, but with no input.
+		engine.Step(false);
+		engine.Events().clear();
+	}
+	double total = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+	sort(stepTimes.begin(), stepTimes.end());
+	double sum = 0.;
+	for(double time : stepTimes)
+		sum += time;
+
+	cout << fixed << setprecision(3);
+	cout << "Saved game load time: " << loadTime << " ms" << '\n';
+	cout << "Derived condition checks: " << conditions.size() << " in " << conditionTime << " ms"
+		<< " (total value " << conditionTotal << ')' << '\n';
+	cout << "Steps: " << steps << " (seed " << seed << ')' << '\n';
+	cout << "Total time: " << total << " s" << '\n';
+	cout << "Steps per second: " << steps / total << '\n';
+	cout << "Step latency (ms): mean " << sum / steps
+		<< ", p50 " << Percentile(stepTimes, .5)
+		<< ", p90 " << Percentile(stepTimes, .9)
+		<< ", p99 " << Percentile(stepTimes, .99)
+		<< ", max " << stepTimes.back() << '\n';
+
+	// Break the time down by phase, to show where any change in speed comes from.
+	const StepProfile &profile = engine.Profile();
+	cout << "Phase times (ms, mean of the last " << profile.Steps() << " steps):" << '\n';
+	for(int i = 0; i <= StepProfile::PHASE_COUNT; ++i)
+		cout << "    " << StepProfile::Name(i) << ": " << profile.Average(i) << '\n';
+	const AI &ai = engine.GetAI();
+	cout << "Firing solution cache hit rate: " << 100. * ai.FiringCacheHitRate() << "% of "
+		<< ai.FiringCacheLookups() << " checks" << '\n';
+	cout.flush();
+	return 0;
+}
+
+
+
+void Benchmark::Help()
+{
+	cerr << "    --benchmark: without opening a window, step the flight simulation of the most recent"
+			" saved game as fast as possible, then print the steps per second and step latencies. The time"
+			" taken to load the saved game and to check some derived conditions is printed too." << endl;
+	cerr << "        --steps <count>: the number of steps to simulate (default: " << DEFAULT_STEPS << ")." << endl;
+	cerr << "        --seed <number>: the seed for the random number generator (default: " << DEFAULT_SEED << ")."
+			<< endl;
+	cerr << "        --save <path>: simulate the given saved game instead of the most recent one." << endl;
+}
@@ -0,0 +1,36 @@
+/* Benchmark.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef BENCHMARK_H_
+#define BENCHMARK_H_
+
+
+
+// A class containing methods used to measure the cost of the flight simulation
+// without a window: a saved game is loaded, the random number generator is
+// seeded, and the Engine is stepped as fast as possible for a fixed number of
+// steps. The throughput and per-step latencies are then printed to the console.
+class Benchmark {
+public:
+	static bool IsBenchmarkArgument(const char *const *argv);
+	// Run the benchmark. The game data must already be loaded. Returns the
+	// process exit code.
+	static int Run(const char *const *argv);
+	static void Help();
+};
+
+
+
+#endif
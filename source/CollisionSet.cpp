@@ -24,6 +24,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Ship.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cstdlib>
 #include <numeric>
 #include <set>
@@ -36,8 +37,9 @@ namespace {
 	constexpr int MAX_VELOCITY = 450000;
 	// Velocity used for any projectiles with v > MAX_VELOCITY
 	constexpr int USED_MAX_VELOCITY = MAX_VELOCITY - 1;
-	// Warn the user only once about too-large projectile velocities.
-	bool warned = false;
+	// Warn the user only once about too-large projectile velocities. Collision
+	// sets may be searched from more than one thread at a time.
+	atomic<bool> warned(false);
 
 
 	// Keep track of the closest collision found so far. If an external "closest
@@ -66,6 +68,39 @@ namespace {
 		double closest_dist;
 		Body *closest_body;
 	};
+
+
+	// An object that a batch of line queries may collide with, along with its
+	// collision mask for the current step.
+	class Candidate {
+	public:
+		Candidate(Body *body, const Mask *mask) : body(body), mask(mask) {}
+
+		Body *body;
+		const Mask *mask;
+	};
+
+
+	// Check whether a line could touch the given object, based only on the
+	// circle that encloses the object's sprite. This is much cheaper than
+	// looking up the object's collision mask, which cannot extend beyond it.
+	// The math is done with Points, which use SSE3 instructions when they are
+	// available. The objects are reached one at a time through the entries'
+	// pointers, so there is no array of positions to test several at once.
+	bool MayTouch(const Body &body, Point from, Point to)
+	{
+		// Convert to a coordinate system where the line starts at the origin.
+		Point p = body.Position() - from;
+		to -= from;
+		double length = to.LengthSquared();
+		// Find the point on the line that is closest to the object's center.
+		if(length)
+			p -= max(0., min(1., to.Dot(p) / length)) * to;
+		// The object's radius is half the diagonal of its sprite.
+		double width = body.Width();
+		double height = body.Height();
+		return p.LengthSquared() <= .25 * (width * width + height * height);
+	}
 }
 
 
@@ -101,6 +136,11 @@ void CollisionSet::Clear(int step)
 	sorted.clear();
 	counts.clear();
 	all.clear();
+	extents.clear();
+	isIncremental = false;
+	cells.clear();
+	bodies.clear();
+	freeHandles.clear();
 	// The counts vector starts with two sentinel slots that will be used in the
 	// course of performing the radix sort.
 	counts.resize(CELLS * CELLS + 2u, 0u);
@@ -111,17 +151,13 @@ void CollisionSet::Clear(int step)
 // Add an object to the set.
 void CollisionSet::Add(Body &body)
 {
-	// Calculate the range of (x, y) grid coordinates this object covers.
-	int minX = static_cast<int>(body.Position().X() - body.Radius()) >> SHIFT;
-	int minY = static_cast<int>(body.Position().Y() - body.Radius()) >> SHIFT;
-	int maxX = static_cast<int>(body.Position().X() + body.Radius()) >> SHIFT;
-	int maxY = static_cast<int>(body.Position().Y() + body.Radius()) >> SHIFT;
+	const Extent extent = GetExtent(body);
 
 	// Add a pointer to this object in every grid cell it occupies.
-	for(int y = minY; y <= maxY; ++y)
+	for(int y = extent.minY; y <= extent.maxY; ++y)
 	{
 		auto gy = y & WRAP_MASK;
-		for(int x = minX; x <= maxX; ++x)
+		for(int x = extent.minX; x <= extent.maxX; ++x)
 		{
 			auto gx = x & WRAP_MASK;
 			added.emplace_back(&body, all.size(), x, y);
@@ -131,6 +167,7 @@ void CollisionSet::Add(Body &body)
 
 	// Also save a pointer to this object irrespective of its grid location.
 	all.emplace_back(&body);
+	extents.push_back(extent);
 }
 
 
@@ -156,10 +193,83 @@ void CollisionSet::Finish()
 	}
 	// Now, counts[index] is where a certain bin begins.
 
-	// Initialize 'seen' with 0
-	seen.clear();
-	seen.resize(all.size());
-	seenEpoch = 0;
+	// Bring each object's animation up to date for this step now, so that the
+	// queries only need to read it.
+	for(Body *body : all)
+		body->GetMask(step);
+}
+
+
+
+// Add an object that will stay in the set until it is removed.
+unsigned CollisionSet::Insert(Body &body)
+{
+	if(!isIncremental)
+	{
+		isIncremental = true;
+		cells.resize(CELLS * CELLS);
+	}
+
+	unsigned handle = bodies.size();
+	if(freeHandles.empty())
+	{
+		bodies.push_back(&body);
+		extents.push_back(GetExtent(body));
+	}
+	else
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+		bodies[handle] = &body;
+		extents[handle] = GetExtent(body);
+	}
+	AddEntries(handle, extents[handle]);
+
+	return handle;
+}
+
+
+
+// Remove the object with the given handle.
+void CollisionSet::Remove(unsigned handle)
+{
+	if(handle >= bodies.size() || !bodies[handle])
+		return;
+
+	RemoveEntries(handle, extents[handle]);
+	bodies[handle] = nullptr;
+	freeHandles.push_back(handle);
+}
+
+
+
+// Move each inserted object to the grid cells that it now covers, and get the
+// set ready to query. Most objects move only a fraction of a cell per step, so
+// their entries can be left where they are.
+void CollisionSet::Update(int step)
+{
+	this->step = step;
+
+	all.clear();
+	for(unsigned handle = 0; handle < bodies.size(); ++handle)
+	{
+		Body *body = bodies[handle];
+		if(!body)
+			continue;
+
+		const Extent extent = GetExtent(*body);
+		if(!(extent == extents[handle]))
+		{
+			RemoveEntries(handle, extents[handle]);
+			extents[handle] = extent;
+			AddEntries(handle, extent);
+		}
+		all.push_back(body);
+
+		// Bring the object's animation up to date for this step now, so that
+		// the queries only need to read it.
+		body->GetMask(step);
+	}
 }
 
 
@@ -203,26 +313,26 @@ Body *CollisionSet::Line(const Point &from, const Point &to, double *closestHit,
 	{
 		// Examine all objects in the current grid cell.
 		const auto index = (gy & WRAP_MASK) * CELLS + (gx & WRAP_MASK);
-		vector<Entry>::const_iterator it = sorted.begin() + counts[index];
-		vector<Entry>::const_iterator end = sorted.begin() + counts[index + 1];
-		for( ; it != end; ++it)
+		for(const Entry &entry : GetCell(index))
 		{
 			// Skip objects that were put in this same grid cell only because
 			// of the cell coordinates wrapping around.
-			if(it->x != gx || it->y != gy)
+			if(entry.x != gx || entry.y != gy)
 				continue;
 
 			// Check if this projectile can hit this object. If either the
 			// projectile or the object has no government, it will always hit.
-			const Government *iGov = it->body->GetGovernment();
-			if(it->body != target && iGov && pGov && !iGov->IsEnemy(pGov))
+			const Government *iGov = entry.body->GetGovernment();
+			if(entry.body != target && iGov && pGov && !iGov->IsEnemy(pGov))
+				continue;
+			if(!MayTouch(*entry.body, from, to))
 				continue;
 
-			const Mask &mask = it->body->GetMask(step);
-			Point offset = from - it->body->Position();
-			const double range = mask.Collide(offset, to - from, it->body->Facing());
+			const Mask &mask = entry.body->GetMask(step);
+			Point offset = from - entry.body->Position();
+			const double range = mask.Collide(offset, to - from, entry.body->Facing());
 
-			closer_result.TryNearer(range, it->body);
+			closer_result.TryNearer(range, entry.body);
 		}
 		if(closer_result.GetClosestDistance() < 1. && closestHit)
 			*closestHit = closer_result.GetClosestDistance();
@@ -234,11 +344,8 @@ Body *CollisionSet::Line(const Point &from, const Point &to, double *closestHit,
 	if(pVelocity.Length() > MAX_VELOCITY)
 	{
 		// Cap projectile velocity to prevent integer overflows.
-		if(!warned)
-		{
+		if(!warned.exchange(true))
 			Logger::LogError("Warning: maximum projectile velocity is " + to_string(MAX_VELOCITY));
-			warned = true;
-		}
 		Point newEnd = from + pVelocity.Unit() * USED_MAX_VELOCITY;
 
 		return Line(from, newEnd, closestHit, pGov, target);
@@ -265,41 +372,46 @@ Body *CollisionSet::Line(const Point &from, const Point &to, double *closestHit,
 	if(stepY > 0)
 		ry = fullScale - ry;
 
-	++seenEpoch;
-
+	// The line only ever moves forward, so any object that it has already
+	// passed through must also cover the grid cell it came from.
+	int previousX = gx;
+	int previousY = gy;
+	bool isFirst = true;
 	while(true)
 	{
 		// Examine all objects in the current grid cell.
 		auto i = (gy & WRAP_MASK) * CELLS + (gx & WRAP_MASK);
-		vector<Entry>::const_iterator it = sorted.begin() + counts[i];
-		vector<Entry>::const_iterator end = sorted.begin() + counts[i + 1];
-		for( ; it != end; ++it)
+		for(const Entry &entry : GetCell(i))
 		{
 			// Skip objects that were put in this same grid cell only because
 			// of the cell coordinates wrapping around.
-			if(it->x != gx || it->y != gy)
+			if(entry.x != gx || entry.y != gy)
 				continue;
 
-			if(seen[it->seenIndex] == seenEpoch)
+			if(!isFirst && extents[entry.index].Contains(previousX, previousY))
 				continue;
-			seen[it->seenIndex] = seenEpoch;
 
 			// Check if this projectile can hit this object. If either the
 			// projectile or the object has no government, it will always hit.
-			const Government *iGov = it->body->GetGovernment();
-			if(it->body != target && iGov && pGov && !iGov->IsEnemy(pGov))
+			const Government *iGov = entry.body->GetGovernment();
+			if(entry.body != target && iGov && pGov && !iGov->IsEnemy(pGov))
+				continue;
+			if(!MayTouch(*entry.body, from, to))
 				continue;
 
-			const Mask &mask = it->body->GetMask(step);
-			Point offset = from - it->body->Position();
-			const double range = mask.Collide(offset, to - from, it->body->Facing());
+			const Mask &mask = entry.body->GetMask(step);
+			Point offset = from - entry.body->Position();
+			const double range = mask.Collide(offset, to - from, entry.body->Facing());
 
-			closer_result.TryNearer(range, it->body);
+			closer_result.TryNearer(range, entry.body);
 		}
 
 		// Check if we've found a collision or reached the final grid cell.
 		if(closer_result.GetClosestBody() || (gx == endGX && gy == endGY))
 			break;
+		previousX = gx;
+		previousY = gy;
+		isFirst = false;
 		// If not, move to the next one. Check whether rx / mx < ry / my.
 		const int64_t diff = rx * my - ry * mx;
 		if(!diff)
@@ -342,10 +454,98 @@ Body *CollisionSet::Line(const Point &from, const Point &to, double *closestHit,
 
 
 
+// Sort a batch of line queries by the grid cell that each one starts in.
+void CollisionSet::Sort(vector<LineQuery> &queries) const
+{
+	// Like the objects in Finish(), the queries are put in order with a radix
+	// sort, which keeps queries that start in the same cell in their original
+	// order.
+	vector<unsigned> cells;
+	cells.reserve(queries.size());
+	vector<unsigned> starts(CELLS * CELLS + 1, 0u);
+	for(const LineQuery &query : queries)
+	{
+		const int gx = static_cast<int>(query.from.X()) >> SHIFT;
+		const int gy = static_cast<int>(query.from.Y()) >> SHIFT;
+		cells.push_back((gy & WRAP_MASK) * CELLS + (gx & WRAP_MASK));
+		++starts[cells.back() + 1];
+	}
+	partial_sum(starts.begin(), starts.end(), starts.begin());
+
+	vector<LineQuery> sortedQueries(queries.size());
+	for(size_t i = 0; i < queries.size(); ++i)
+		sortedQueries[starts[cells[i]]++] = queries[i];
+	queries.swap(sortedQueries);
+}
+
+
+
+// Resolve each of the given line queries.
+void CollisionSet::Lines(LineQuery *begin, LineQuery *end) const
+{
+	// Most lines are short enough to lie within a single grid cell. Since the
+	// queries are sorted by cell, those that lie within the same cell come one
+	// after another, and they share one list of the objects in that cell, with
+	// each object's collision mask already looked up. Only the lines that cross
+	// into other cells walk the grid on their own.
+	vector<Candidate> candidates;
+	int candidateX = 0;
+	int candidateY = 0;
+	bool hasCandidates = false;
+	for(LineQuery *query = begin; query != end; ++query)
+	{
+		const int gx = static_cast<int>(query->from.X()) >> SHIFT;
+		const int gy = static_cast<int>(query->from.Y()) >> SHIFT;
+		const int endGX = static_cast<int>(query->to.X()) >> SHIFT;
+		const int endGY = static_cast<int>(query->to.Y()) >> SHIFT;
+		if(gx != endGX || gy != endGY)
+		{
+			query->hit = Line(query->from, query->to, &query->closestHit, query->pGov, query->target);
+			continue;
+		}
+
+		if(!hasCandidates || gx != candidateX || gy != candidateY)
+		{
+			candidates.clear();
+			const auto index = (gy & WRAP_MASK) * CELLS + (gx & WRAP_MASK);
+			for(const Entry &entry : GetCell(index))
+				// Skip objects that were put in this same grid cell only
+				// because of the cell coordinates wrapping around.
+				if(entry.x == gx && entry.y == gy)
+					candidates.emplace_back(entry.body, &entry.body->GetMask(step));
+			candidateX = gx;
+			candidateY = gy;
+			hasCandidates = true;
+		}
+
+		// Check the objects in the same order as Line() would, so the result
+		// is the same even if two objects are hit at the same distance.
+		Closest closest(query->closestHit);
+		for(const Candidate &candidate : candidates)
+		{
+			Body *body = candidate.body;
+			const Government *iGov = body->GetGovernment();
+			if(body != query->target && iGov && query->pGov && !iGov->IsEnemy(query->pGov))
+				continue;
+			if(!MayTouch(*body, query->from, query->to))
+				continue;
+
+			Point offset = query->from - body->Position();
+			closest.TryNearer(candidate.mask->Collide(offset, query->to - query->from, body->Facing()), body);
+		}
+		if(closest.GetClosestDistance() < 1.)
+			query->closestHit = closest.GetClosestDistance();
+		query->hit = closest.GetClosestBody();
+	}
+}
+
+
+
 // Get all objects within the given range of the given point.
 const vector<Body *> &CollisionSet::Circle(const Point &center, double radius) const
 {
-	return Ring(center, 0., radius);
+	Ring(center, 0., radius, result);
+	return result;
 }
 
 
@@ -353,6 +553,25 @@ const vector<Body *> &CollisionSet::Circle(const Point &center, double radius) c
 // Get all objects touching a ring with a given inner and outer range
 // centered at the given point.
 const vector<Body *> &CollisionSet::Ring(const Point &center, double inner, double outer) const
+{
+	Ring(center, inner, outer, result);
+	return result;
+}
+
+
+
+// Get all objects within the given range of the given point, storing them in
+// the given vector.
+void CollisionSet::Circle(const Point &center, double radius, vector<Body *> &objects) const
+{
+	Ring(center, 0., radius, objects);
+}
+
+
+
+// Get all objects touching a ring with a given inner and outer range centered
+// at the given point, storing them in the given vector.
+void CollisionSet::Ring(const Point &center, double inner, double outer, vector<Body *> &objects) const
 {
 	// Calculate the range of (x, y) grid coordinates this ring covers.
 	const int minX = static_cast<int>(center.X() - outer) >> SHIFT;
@@ -360,9 +579,7 @@ const vector<Body *> &CollisionSet::Ring(const Point &center, double inner, doub
 	const int maxX = static_cast<int>(center.X() + outer) >> SHIFT;
 	const int maxY = static_cast<int>(center.Y() + outer) >> SHIFT;
 
-	++seenEpoch;
-
-	result.clear();
+	objects.clear();
 	for(int y = minY; y <= maxY; ++y)
 	{
 		const auto gy = y & WRAP_MASK;
@@ -370,30 +587,28 @@ const vector<Body *> &CollisionSet::Ring(const Point &center, double inner, doub
 		{
 			const auto gx = x & WRAP_MASK;
 			const auto index = gy * CELLS + gx;
-			vector<Entry>::const_iterator it = sorted.begin() + counts[index];
-			vector<Entry>::const_iterator end = sorted.begin() + counts[index + 1];
-
-			for( ; it != end; ++it)
+			for(const Entry &entry : GetCell(index))
 			{
 				// Skip objects that were put in this same grid cell only because
 				// of the cell coordinates wrapping around.
-				if(it->x != x || it->y != y)
+				if(entry.x != x || entry.y != y)
 					continue;
 
-				if(seen[it->seenIndex] == seenEpoch)
+				// Only check each object in the first of its cells that is
+				// within range.
+				const Extent &extent = extents[entry.index];
+				if(x != max(extent.minX, minX) || y != max(extent.minY, minY))
 					continue;
-				seen[it->seenIndex] = seenEpoch;
 
-				const Mask &mask = it->body->GetMask(step);
-				Point offset = center - it->body->Position();
+				const Mask &mask = entry.body->GetMask(step);
+				Point offset = center - entry.body->Position();
 				const double length = offset.Length();
 				if((length <= outer && length >= inner)
-					|| mask.WithinRing(offset, it->body->Facing(), inner, outer))
-					result.push_back(it->body);
+					|| mask.WithinRing(offset, entry.body->Facing(), inner, outer))
+					objects.push_back(entry.body);
 			}
 		}
 	}
-	return result;
 }
 
 
@@ -402,3 +617,58 @@ const vector<Body *> &CollisionSet::All() const
 {
 	return all;
 }
+
+
+
+// Get the range of grid cells that the given object covers.
+CollisionSet::Extent CollisionSet::GetExtent(const Body &body) const
+{
+	return Extent(
+		static_cast<int>(body.Position().X() - body.Radius()) >> SHIFT,
+		static_cast<int>(body.Position().Y() - body.Radius()) >> SHIFT,
+		static_cast<int>(body.Position().X() + body.Radius()) >> SHIFT,
+		static_cast<int>(body.Position().Y() + body.Radius()) >> SHIFT);
+}
+
+
+
+// Get the objects in the grid cell with the given (wrapped) index.
+CollisionSet::Cell CollisionSet::GetCell(unsigned index) const
+{
+	if(isIncremental)
+	{
+		const vector<Entry> &cell = cells[index];
+		return Cell(cell.data(), cell.data() + cell.size());
+	}
+	return Cell(sorted.data() + counts[index], sorted.data() + counts[index + 1]);
+}
+
+
+
+// Add an entry for an inserted object to every grid cell it covers.
+void CollisionSet::AddEntries(unsigned handle, const Extent &extent)
+{
+	for(int y = extent.minY; y <= extent.maxY; ++y)
+		for(int x = extent.minX; x <= extent.maxX; ++x)
+			cells[(y & WRAP_MASK) * CELLS + (x & WRAP_MASK)].emplace_back(bodies[handle], handle, x, y);
+}
+
+
+
+// Remove an inserted object's entries from the grid cells it covers. The order
+// of the entries in a cell does not matter, so each one is replaced by the last.
+void CollisionSet::RemoveEntries(unsigned handle, const Extent &extent)
+{
+	for(int y = extent.minY; y <= extent.maxY; ++y)
+		for(int x = extent.minX; x <= extent.maxX; ++x)
+		{
+			vector<Entry> &cell = cells[(y & WRAP_MASK) * CELLS + (x & WRAP_MASK)];
+			for(Entry &entry : cell)
+				if(entry.index == handle && entry.x == x && entry.y == y)
+				{
+					entry = cell.back();
+					cell.pop_back();
+					break;
+				}
+		}
+}
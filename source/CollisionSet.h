@@ -16,10 +16,12 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef COLLISION_SET_H_
 #define COLLISION_SET_H_
 
+#include "Point.h"
+
+#include <cstddef>
 #include <vector>
 
 class Government;
-class Point;
 class Projectile;
 class Body;
 
@@ -28,7 +30,37 @@ class Body;
 // A CollisionSet allows efficient collision detection by splitting space up
 // into a grid and keeping track of which objects are in each grid cell. A check
 // for collisions can then only examine objects in certain cells.
+//
+// A set can either be rebuilt from scratch every step, using Clear(), Add(),
+// and Finish(), or keep its objects from one step to the next, using Insert(),
+// Remove(), and Update(). In the latter case, only the objects that have moved
+// into different grid cells are re-sorted. The two ways of filling a set
+// should not be mixed, except that Clear() empties a set of either kind.
 class CollisionSet {
+public:
+	// A check for the first object that a line collides with, to be resolved
+	// as part of a batch of such checks.
+	class LineQuery {
+	public:
+		LineQuery() = default;
+		LineQuery(const Point &from, const Point &to, const Government *pGov, const Body *target, std::size_t index)
+			: from(from), to(to), pGov(pGov), target(target), index(index) {}
+
+		Point from;
+		Point to;
+		const Government *pGov = nullptr;
+		const Body *target = nullptr;
+		// Only objects closer than this fraction of the line are checked. Once
+		// the query is resolved, this is how far along the line the hit is.
+		double closestHit = 1.;
+		// The object that was hit, if any.
+		Body *hit = nullptr;
+		// A number for the caller to match up queries with their results, since
+		// sorting the queries changes their order.
+		std::size_t index = 0;
+	};
+
+
 public:
 	// Initialize a collision set. The cell size and cell count should both be
 	// powers of two; otherwise, they are rounded down to a power of two.
@@ -42,6 +74,16 @@ public:
 	// Finish adding objects (and organize them into the final lookup table).
 	void Finish();
 
+	// Add an object that will stay in the set until it is removed. The returned
+	// handle stays valid until then, and may be reused afterwards.
+	unsigned Insert(Body &body);
+	// Remove the object with the given handle. The object itself is not
+	// accessed, so it may already have been destroyed.
+	void Remove(unsigned handle);
+	// Move each inserted object to the grid cells that it now covers, and get
+	// the set ready to query. Specify which engine step we are on.
+	void Update(int step);
+
 	// Get the first object that collides with the given projectile. If a
 	// "closest hit" value is given, update that value.
 	Body *Line(const Projectile &projectile, double *closestHit = nullptr) const;
@@ -49,12 +91,24 @@ public:
 	// position or its entire expected trajectory (for the auto-firing AI).
 	Body *Line(const Point &from, const Point &to, double *closestHit = nullptr,
 		const Government *pGov = nullptr, const Body *target = nullptr) const;
+	// Sort a batch of line queries by the grid cell that each one starts in, so
+	// that queries which examine the same cells are resolved one after another.
+	void Sort(std::vector<LineQuery> &queries) const;
+	// Resolve each of the given line queries, which should have been sorted.
+	// Queries that lie within the same grid cell share the work of finding the
+	// objects in it. Several threads may resolve separate ranges of a batch at once.
+	void Lines(LineQuery *begin, LineQuery *end) const;
 
 	// Get all objects within the given range of the given point.
 	const std::vector<Body *> &Circle(const Point &center, double radius) const;
 	// Get all objects touching a ring with a given inner and outer range
 	// centered at the given point.
 	const std::vector<Body *> &Ring(const Point &center, double inner, double outer) const;
+	// As above, but store the objects in the given vector instead of in this
+	// set. Line queries and these overloads do not modify the set, so any
+	// number of threads may use them at once.
+	void Circle(const Point &center, double radius, std::vector<Body *> &objects) const;
+	void Ring(const Point &center, double inner, double outer, std::vector<Body *> &objects) const;
 
 	// Get all objects within this collision set.
 	const std::vector<Body *> &All() const;
@@ -64,14 +118,55 @@ private:
 	class Entry {
 	public:
 		Entry() = default;
-		Entry(Body *body, unsigned seenIndex, int x, int y) : body(body), seenIndex(seenIndex), x(x), y(y) {}
+		Entry(Body *body, unsigned index, int x, int y) : body(body), index(index), x(x), y(y) {}
 
 		Body *body;
-		unsigned seenIndex;
+		unsigned index;
 		int x;
 		int y;
 	};
 
+	// The range of grid cells that an object covers.
+	class Extent {
+	public:
+		Extent() = default;
+		Extent(int minX, int minY, int maxX, int maxY) : minX(minX), minY(minY), maxX(maxX), maxY(maxY) {}
+
+		bool Contains(int x, int y) const { return x >= minX && x <= maxX && y >= minY && y <= maxY; }
+		bool operator==(const Extent &other) const
+		{
+			return minX == other.minX && minY == other.minY && maxX == other.maxX && maxY == other.maxY;
+		}
+
+		int minX;
+		int minY;
+		int maxX;
+		int maxY;
+	};
+
+	// The objects stored in one grid cell.
+	class Cell {
+	public:
+		Cell(const Entry *first, const Entry *last) : first(first), last(last) {}
+
+		const Entry *begin() const { return first; }
+		const Entry *end() const { return last; }
+
+	private:
+		const Entry *first;
+		const Entry *last;
+	};
+
+
+private:
+	// Get the range of grid cells that the given object covers.
+	Extent GetExtent(const Body &body) const;
+	// Get the objects in the grid cell with the given (wrapped) index.
+	Cell GetCell(unsigned index) const;
+	// Add or remove an inserted object's entries in the grid cells it covers.
+	void AddEntries(unsigned handle, const Extent &extent);
+	void RemoveEntries(unsigned handle, const Extent &extent);
+
 
 private:
 	// The size of individual cells of the grid.
@@ -88,17 +183,27 @@ private:
 
 	// Vectors to store the objects in the collision set.
 	std::vector<Body *> all;
+	// The grid cells covered by each object, in the same order as "all" (or,
+	// for inserted objects, indexed by handle). An object that covers several
+	// cells is only checked once per query by skipping it in all but one of
+	// the cells it shares with that query.
+	std::vector<Extent> extents;
 	std::vector<Entry> added;
 	std::vector<Entry> sorted;
 	// After Finish(), counts[index] is where a certain bin begins.
 	std::vector<unsigned> counts;
 
+	// Whether the objects were inserted rather than added.
+	bool isIncremental = false;
+	// The contents of each grid cell, if the objects were inserted.
+	std::vector<std::vector<Entry>> cells;
+	// The inserted objects, indexed by their handles. The extents are indexed
+	// the same way. The handles of removed objects are reused.
+	std::vector<Body *> bodies;
+	std::vector<unsigned> freeHandles;
+
 	// Vector for returning the result of a circle query.
 	mutable std::vector<Body *> result;
-
-	// Keep track of which objects we've already considered
-	mutable std::vector<unsigned> seen;
-	mutable unsigned seenEpoch = 0;
 };
 
 
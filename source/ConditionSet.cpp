@@ -153,18 +153,20 @@ namespace {
 
 	// Converts the given vector of condition tokens (like "reputation: Republic",
 	// "random", or "4") into the integral values they have at runtime.
-	vector<int64_t> SubstituteValues(const vector<string> &side, const ConditionsStore &conditions,
-		const ConditionsStore &created)
+	// The numeric tokens have already been converted, and are given in "values".
+	vector<int64_t> SubstituteValues(const vector<string> &side, const vector<double> &values,
+		const ConditionsStore &conditions, const ConditionsStore &created)
 	{
 		auto result = vector<int64_t>();
 		result.reserve(side.size());
-		for(const string &str : side)
+		for(size_t i = 0; i < side.size(); ++i)
 		{
+			const string &str = side[i];
 			int64_t value = 0;
-			if(str == "random")
+			if(!std::isnan(values[i]))
+				value = static_cast<int64_t>(values[i]);
+			else if(str == "random")
 				value = Random::Int(100);
-			else if(DataNode::IsNumber(str))
-				value = static_cast<int64_t>(DataNode::Value(str));
 			else
 			{
 				const auto temp = created.HasGet(str);
@@ -600,6 +602,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 
 	ParseSide(side);
 	GenerateSequence();
+	FindValues();
 }
 
 
@@ -609,6 +612,7 @@ ConditionSet::Expression::SubExpression::SubExpression(const vector<string> &sid
 ConditionSet::Expression::SubExpression::SubExpression(const string &side)
 {
 	tokens.emplace_back(side.empty() ? "'" : side);
+	FindValues();
 }
 
 
@@ -678,7 +682,7 @@ int64_t ConditionSet::Expression::SubExpression::Evaluate(const ConditionsStore
 
 	// For SubExpressions with no Operations (i.e. simple conditions), tokens will consist
 	// of only the condition or numeric value to be returned as-is after substitution.
-	auto data = SubstituteValues(tokens, conditions, created);
+	auto data = SubstituteValues(tokens, values, conditions, created);
 
 	if(!sequence.empty())
 	{
@@ -810,6 +814,18 @@ void ConditionSet::Expression::SubExpression::GenerateSequence()
 
 
 
+// Convert each token that is a number to its value, once, instead of each
+// time that this SubExpression is evaluated.
+void ConditionSet::Expression::SubExpression::FindValues()
+{
+	values.clear();
+	values.reserve(tokens.size());
+	for(const string &token : tokens)
+		values.push_back(DataNode::IsNumber(token) ? DataNode::Value(token) : numeric_limits<double>::quiet_NaN());
+}
+
+
+
 // Use a valid working index and data pointer vector to create an evaluable Operation.
 bool ConditionSet::Expression::SubExpression::AddOperation(vector<int> &data, size_t &index, const size_t &opIndex)
 {
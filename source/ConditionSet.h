@@ -124,6 +124,7 @@ private:
 		private:
 			void ParseSide(const std::vector<std::string> &side);
 			void GenerateSequence();
+			void FindValues();
 			bool AddOperation(std::vector<int> &data, size_t &index, const size_t &opIndex);
 
 
@@ -145,6 +146,9 @@ private:
 			std::vector<Operation> sequence;
 			// The tokens vector converts into a data vector of numeric values during evaluation.
 			std::vector<std::string> tokens;
+			// The value of each token that is a number, or NaN for any other token,
+			// so that the numbers need not be parsed again for each evaluation.
+			std::vector<double> values;
 			std::vector<std::string> operators;
 			// The number of true (non-parentheses) operators.
 			int operatorCount = 0;
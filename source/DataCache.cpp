@@ -0,0 +1,222 @@
+/* DataCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DataCache.h"
+
+#include "DataFile.h"
+#include "Files.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace {
+	// The first bytes of a cache file. This must change whenever the format of
+	// the cache, or the way that data files are parsed, changes.
+	const string HEADER = "Endless Sky data cache 2\n";
+
+	// A file's contents are identified by a hash in the style of FNV-1a, taken
+	// eight bytes at a time. Each step of it is reversible, so two files of the
+	// same size that differ in only one place never have the same hash. Reading
+	// the whole file to hash it is still much faster than parsing it, and unlike
+	// a modification time it cannot miss a change made within the same second.
+	uint64_t Hash(const char *begin, const char *end)
+	{
+		const uint64_t PRIME = 1099511628211ull;
+		uint64_t hash = 14695981039346656037ull;
+		const char *it = begin;
+		for( ; end - it >= 8; it += 8)
+		{
+			uint64_t word = 0;
+			memcpy(&word, it, 8);
+			hash = (hash ^ word) * PRIME;
+		}
+		for( ; it != end; ++it)
+			hash = (hash ^ static_cast<unsigned char>(*it)) * PRIME;
+		return hash;
+	}
+
+	// The numbers in the index are stored as eight bytes, least significant first.
+	void WriteNumber(uint64_t value, string &out)
+	{
+		for(int i = 0; i < 8; ++i, value >>= 8)
+			out += static_cast<char>(value & 0xFF);
+	}
+
+	bool ReadNumber(const char *&pos, const char *end, uint64_t &value)
+	{
+		if(end - pos < 8)
+			return false;
+		value = 0;
+		for(int i = 0; i < 8; ++i)
+			value |= static_cast<uint64_t>(static_cast<unsigned char>(pos[i])) << (8 * i);
+		pos += 8;
+		return true;
+	}
+
+	// Read a string of bytes that is preceded by its length.
+	bool ReadBytes(const char *&pos, const char *end, const char *&begin, const char *&last)
+	{
+		uint64_t length = 0;
+		if(!ReadNumber(pos, end, length) || length > static_cast<uint64_t>(end - pos))
+			return false;
+		begin = pos;
+		pos += length;
+		last = pos;
+		return true;
+	}
+}
+
+
+
+// Read the index of the cache stored at the given path, if there is one.
+DataCache::DataCache(const string &path)
+	: path(path), hits(0), misses(0)
+{
+	if(!Files::Exists(path))
+		return;
+
+	file.reset(new MappedFile(path));
+	const char *pos = file->begin();
+	const char *end = file->end();
+	if(static_cast<size_t>(end - pos) < HEADER.size() || !equal(HEADER.begin(), HEADER.end(), pos))
+		return;
+
+	// Each entry is a path, the size and hash that file had, and then its
+	// packed nodes. Stop at the first entry that is cut short.
+	pos += HEADER.size();
+	while(pos < end)
+	{
+		const char *pathBegin = nullptr;
+		const char *pathEnd = nullptr;
+		uint64_t size = 0;
+		uint64_t hash = 0;
+		Entry entry;
+		if(!ReadBytes(pos, end, pathBegin, pathEnd) || !ReadNumber(pos, end, size)
+				|| !ReadNumber(pos, end, hash) || !ReadBytes(pos, end, entry.begin, entry.end))
+			break;
+
+		entry.size = size;
+		entry.hash = hash;
+		cached[string(pathBegin, pathEnd)] = entry;
+	}
+}
+
+
+
+// The mapped file is only closed here, where MappedFile is a complete type.
+DataCache::~DataCache()
+{
+}
+
+
+
+// Load the given data file from the cache if it has not changed since it was
+// stored there. Otherwise, parse it, and remember its contents so that they
+// can be stored in the cache.
+void DataCache::Load(const string &path, DataFile &file)
+{
+	Entry entry;
+	{
+		const MappedFile contents(path);
+		entry.size = contents.Size();
+		entry.hash = Hash(contents.begin(), contents.end());
+	}
+
+	auto it = cached.find(path);
+	if(it != cached.end() && it->second.size == entry.size && it->second.hash == entry.hash
+			&& file.Unpack(it->second.begin, it->second.end))
+	{
+		++hits;
+		entry.begin = it->second.begin;
+		entry.end = it->second.end;
+	}
+	else
+	{
+		++misses;
+		file = DataFile(path);
+		// A file with mistakes in its format is never cached, so that the
+		// warnings about them are printed every time it is loaded.
+		if(file.HasWarnings())
+			return;
+		file.Pack(entry.packed);
+	}
+
+	lock_guard<mutex> lock(loadedMutex);
+	isChanged |= !entry.begin;
+	loaded[path] = move(entry);
+}
+
+
+
+// If any of the files that were loaded were not in the cache, or if any of the
+// files in the cache were not loaded, replace the cache with all of the files
+// that were loaded. Files that were not cached because of their warnings do not
+// count, since storing the cache again would not change that.
+void DataCache::Save() const
+{
+	lock_guard<mutex> lock(loadedMutex);
+	// Every loaded file that was not changed came from the cache, so if there
+	// are as many of them as there are cached files, they are the same files.
+	if(!isChanged && loaded.size() == cached.size())
+		return;
+
+	string out = HEADER;
+	for(const auto &it : loaded)
+	{
+		const Entry &entry = it.second;
+		WriteNumber(it.first.size(), out);
+		out += it.first;
+		WriteNumber(entry.size, out);
+		WriteNumber(entry.hash, out);
+		if(entry.begin)
+		{
+			WriteNumber(entry.end - entry.begin, out);
+			out.append(entry.begin, entry.end);
+		}
+		else
+		{
+			WriteNumber(entry.packed.size(), out);
+			out += entry.packed;
+		}
+	}
+
+	// Write the new cache to a separate file first, so that the old one is not
+	// left half-written if writing fails. The old one may still be mapped into
+	// memory, but replacing it does not change what is mapped.
+	const string newPath = path + ".new";
+	Files::Write(newPath, out);
+	if(Files::Size(newPath) == out.size())
+		Files::Move(newPath, path);
+	else
+		Files::Delete(newPath);
+}
+
+
+
+// Get the number of files that were or were not found in the cache.
+size_t DataCache::Hits() const
+{
+	return hits;
+}
+
+
+
+size_t DataCache::Misses() const
+{
+	return misses;
+}
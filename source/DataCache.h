@@ -0,0 +1,86 @@
+/* DataCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DATA_CACHE_H_
+#define DATA_CACHE_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+class DataFile;
+class MappedFile;
+
+
+
+// A cache of the parsed contents of data files, all stored together in one
+// binary file. A data file that has the same size and contents (compared by
+// their hash) as when it was cached can be loaded without parsing it again. Any number of
+// threads may load files through the cache at once.
+class DataCache {
+public:
+	// Read the index of the cache stored at the given path, if there is one.
+	explicit DataCache(const std::string &path);
+	~DataCache();
+
+	// Load the given data file from the cache if it has not changed since it
+	// was stored there. Otherwise, parse it, and remember its contents so that
+	// they can be stored in the cache.
+	void Load(const std::string &path, DataFile &file);
+	// If any of the files that were loaded were not in the cache, or if any of
+	// the files in the cache were not loaded, replace the cache with all of the
+	// files that were loaded. Files with warnings are never stored, so they do
+	// not cause the cache to be replaced.
+	void Save() const;
+
+	// Get the number of files that were or were not found in the cache.
+	std::size_t Hits() const;
+	std::size_t Misses() const;
+
+
+private:
+	class Entry {
+	public:
+		std::size_t size = 0;
+		uint64_t hash = 0;
+		// The packed nodes, either in the cache file or stored here.
+		const char *begin = nullptr;
+		const char *end = nullptr;
+		std::string packed;
+	};
+
+
+private:
+	std::string path;
+	std::unique_ptr<MappedFile> file;
+	// The files in the cache when it was opened, and the ones loaded since then.
+	std::unordered_map<std::string, Entry> cached;
+	std::map<std::string, Entry> loaded;
+	// Whether any file has been parsed and stored since the cache was read.
+	bool isChanged = false;
+	mutable std::mutex loadedMutex;
+
+	std::atomic<std::size_t> hits;
+	std::atomic<std::size_t> misses;
+};
+
+
+
+#endif
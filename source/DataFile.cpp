@@ -15,11 +15,52 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "DataFile.h"
 
-#include "Files.h"
-#include "text/Utf8.h"
+#include "MappedFile.h"
+
+#include <utility>
+#include <vector>
 
 using namespace std;
 
+namespace {
+	// Get the next character of the text, or a newline once the end of the
+	// text is reached, so that the last line always ends in one. All of the
+	// characters that separate tokens are ASCII, and every byte of a multi-byte
+	// UTF-8 character is outside of that range, so the text can be scanned one
+	// byte at a time without decoding it. (Malformed UTF-8 that encodes one of
+	// those characters in more bytes than it needs is therefore part of a
+	// token, instead of separating tokens.)
+	inline char32_t Next(const char *&pos, const char *end)
+	{
+		return (pos < end) ? static_cast<unsigned char>(*pos++) : '\n';
+	}
+
+	// Packed numbers are stored seven bits at a time, with the high bit of each
+	// byte set if more bytes follow.
+	void PackNumber(size_t value, string &out)
+	{
+		while(value >= 0x80)
+		{
+			out += static_cast<char>((value & 0x7F) | 0x80);
+			value >>= 7;
+		}
+		out += static_cast<char>(value);
+	}
+
+	bool UnpackNumber(const char *&pos, const char *end, size_t &value)
+	{
+		value = 0;
+		for(int shift = 0; pos < end && shift < 64; shift += 7)
+		{
+			unsigned char byte = *pos++;
+			value |= static_cast<size_t>(byte & 0x7F) << shift;
+			if(!(byte & 0x80))
+				return true;
+		}
+		return false;
+	}
+}
+
 
 
 // Constructor, taking a file path (in UTF-8).
@@ -38,22 +79,19 @@ DataFile::DataFile(istream &in)
 
 
 
-// Load from a file path (in UTF-8).
+// Load from a file path (in UTF-8). The file is mapped into memory rather
+// than copied, if possible.
 void DataFile::Load(const string &path)
 {
-	string data = Files::Read(path);
-	if(data.empty())
+	const MappedFile file(path);
+	if(file.IsEmpty())
 		return;
 
-	// As a sentinel, make sure the file always ends in a newline.
-	if(data.back() != '\n')
-		data.push_back('\n');
-
 	// Note what file this node is in, so it will show up in error traces.
-	root.tokens.push_back("file");
-	root.tokens.push_back(path);
+	root.AddToken("file", 4);
+	root.AddToken(path.data(), path.size());
 
-	LoadData(data);
+	LoadData(file.begin(), file.end());
 }
 
 
@@ -71,11 +109,8 @@ void DataFile::Load(istream &in)
 		in.read(&*data.begin() + currentSize, BLOCK);
 		data.resize(currentSize + in.gcount());
 	}
-	// As a sentinel, make sure the file always ends in a newline.
-	if(data.empty() || data.back() != '\n')
-		data.push_back('\n');
 
-	LoadData(data);
+	LoadData(data.data(), data.data() + data.size());
 }
 
 
@@ -96,8 +131,41 @@ list<DataNode>::const_iterator DataFile::end() const
 
 
 
-// Parse the given text.
-void DataFile::LoadData(const string &data)
+// Check if any warnings about the format of the file were printed while it
+// was being parsed.
+bool DataFile::HasWarnings() const
+{
+	return hasWarnings;
+}
+
+
+
+// Store this file's nodes in a compact binary form.
+void DataFile::Pack(string &out) const
+{
+	PackNode(root, out);
+}
+
+
+
+// Replace this file's nodes with ones that were stored in the binary form.
+// If the data is not in that form, this file is left empty.
+bool DataFile::Unpack(const char *begin, const char *end)
+{
+	root = DataNode();
+	hasWarnings = false;
+	if(UnpackNode(root, begin, end) && begin == end)
+		return true;
+
+	root = DataNode();
+	return false;
+}
+
+
+
+// Parse the given text. Each token is found in place and then copied into its
+// node, so the text does not need to outlive this call.
+void DataFile::LoadData(const char *begin, const char *end)
 {
 	// Keep track of the current stack of indentation levels and the most recent
 	// node at each level - that is, the node that will be the "parent" of any
@@ -108,12 +176,15 @@ void DataFile::LoadData(const string &data)
 	bool fileIsSpaces = false;
 	size_t lineNumber = 0;
 
-	size_t end = data.length();
-	for(size_t pos = 0; pos < end; )
+	// The start and length of each token in the current line. Once the whole
+	// line has been read, they are all copied into the node at once.
+	vector<pair<const char *, size_t>> tokens;
+
+	for(const char *pos = begin; pos < end; )
 	{
 		++lineNumber;
-		size_t tokenPos = pos;
-		char32_t c = Utf8::DecodeCodePoint(data, pos);
+		const char *tokenPos = pos;
+		char32_t c = Next(pos, end);
 
 		bool mixedIndentation = false;
 		int separators = 0;
@@ -134,16 +205,19 @@ void DataFile::LoadData(const string &data)
 
 			++separators;
 			tokenPos = pos;
-			c = Utf8::DecodeCodePoint(data, pos);
+			c = Next(pos, end);
 		}
 
 		// If the line is a comment, skip to the end of the line.
 		if(c == '#')
 		{
 			if(mixedIndentation)
+			{
 				root.PrintTrace("Warning: Mixed whitespace usage for comment at line " + to_string(lineNumber));
+				hasWarnings = true;
+			}
 			while(c != '\n')
-				c = Utf8::DecodeCodePoint(data, pos);
+				c = Next(pos, end);
 		}
 		// Skip empty lines (including comment lines).
 		if(c == '\n')
@@ -168,6 +242,8 @@ void DataFile::LoadData(const string &data)
 		separatorStack.push_back(separators);
 
 		// Tokenize the line. Skip comments and empty lines.
+		tokens.clear();
+		bool missingQuote = false;
 		while(c != '\n')
 		{
 			// Check if this token begins with a quotation mark. If so, it will
@@ -177,28 +253,21 @@ void DataFile::LoadData(const string &data)
 			if(isQuoted)
 			{
 				tokenPos = pos;
-				c = Utf8::DecodeCodePoint(data, pos);
+				c = Next(pos, end);
 			}
 
-			size_t endPos = tokenPos;
+			const char *endPos = tokenPos;
 
 			// Find the end of this token.
 			while(c != '\n' && (isQuoted ? (c != endQuote) : (c > ' ')))
 			{
 				endPos = pos;
-				c = Utf8::DecodeCodePoint(data, pos);
+				c = Next(pos, end);
 			}
 
-			// It ought to be legal to construct a string from an empty iterator
-			// range, but it appears that some libraries do not handle that case
-			// correctly. So:
-			if(tokenPos == endPos)
-				node.tokens.emplace_back();
-			else
-				node.tokens.emplace_back(data, tokenPos, endPos - tokenPos);
+			tokens.emplace_back(tokenPos, endPos - tokenPos);
 			// This is not a fatal error, but it may indicate a format mistake:
-			if(isQuoted && c == '\n')
-				node.PrintTrace("Warning: Closing quotation mark is missing:");
+			missingQuote |= (isQuoted && c == '\n');
 
 			if(c != '\n')
 			{
@@ -207,12 +276,12 @@ void DataFile::LoadData(const string &data)
 				if(isQuoted)
 				{
 					tokenPos = pos;
-					c = Utf8::DecodeCodePoint(data, pos);
+					c = Next(pos, end);
 				}
 				while(c != '\n' && c <= ' ' && c != '#')
 				{
 					tokenPos = pos;
-					c = Utf8::DecodeCodePoint(data, pos);
+					c = Next(pos, end);
 				}
 
 				// If a comment is encountered outside of a token, skip the rest
@@ -220,15 +289,74 @@ void DataFile::LoadData(const string &data)
 				if(c == '#')
 				{
 					while(c != '\n')
-						c = Utf8::DecodeCodePoint(data, pos);
+						c = Next(pos, end);
 				}
 			}
 		}
-		// Now that we've reached the end of the line, we know no more tokens will be added to the node.
-		node.tokens.shrink_to_fit();
-
+		// Now that we've reached the end of the line, we know how many tokens
+		// this node has, so they can all be stored with a single allocation.
+		// (Most tokens are short enough to not need an allocation of their own.)
+		node.tokens.reserve(tokens.size());
+		node.values.reserve(tokens.size());
+		for(const auto &token : tokens)
+			node.AddToken(token.first, token.second);
+
+		// A token that is missing its closing quotation mark is always the last
+		// one in its line, so the warning can wait until the node is complete.
+		if(missingQuote)
+			node.PrintTrace("Warning: Closing quotation mark is missing:");
 		// Now that we've tokenized this node, print any mixed whitespace warnings.
 		if(mixedIndentation)
 			node.PrintTrace("Warning: Mixed whitespace usage at line");
+		hasWarnings |= missingQuote || mixedIndentation;
+	}
+}
+
+
+
+// Each node is stored as its line number, its tokens, and then its children.
+void DataFile::PackNode(const DataNode &node, string &out)
+{
+	PackNumber(node.lineNumber, out);
+	PackNumber(node.tokens.size(), out);
+	for(const string &token : node.tokens)
+	{
+		PackNumber(token.size(), out);
+		out += token;
+	}
+	PackNumber(node.children.size(), out);
+	for(const DataNode &child : node.children)
+		PackNode(child, out);
+}
+
+
+
+bool DataFile::UnpackNode(DataNode &node, const char *&pos, const char *end)
+{
+	size_t count = 0;
+	if(!UnpackNumber(pos, end, node.lineNumber) || !UnpackNumber(pos, end, count))
+		return false;
+	// Every token takes up at least one byte.
+	if(count > static_cast<size_t>(end - pos))
+		return false;
+	node.tokens.reserve(count);
+	node.values.reserve(count);
+	for(size_t i = 0; i < count; ++i)
+	{
+		size_t length = 0;
+		if(!UnpackNumber(pos, end, length) || length > static_cast<size_t>(end - pos))
+			return false;
+		node.AddToken(pos, length);
+		pos += length;
+	}
+
+	if(!UnpackNumber(pos, end, count) || count > static_cast<size_t>(end - pos))
+		return false;
+	for(size_t i = 0; i < count; ++i)
+	{
+		node.children.emplace_back(&node);
+		if(!UnpackNode(node.children.back(), pos, end))
+			return false;
 	}
+	return true;
 }
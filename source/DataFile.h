@@ -44,14 +44,30 @@ public:
 	std::list<DataNode>::const_iterator begin() const;
 	std::list<DataNode>::const_iterator end() const;
 
+	// Check if any warnings about the format of the file were printed while
+	// it was being parsed.
+	bool HasWarnings() const;
+
+	// Store this file's nodes in a compact binary form, or replace them with
+	// nodes stored that way, so that a file that has not changed does not need
+	// to be parsed again. Unpacking fails if the data is not in that form.
+	void Pack(std::string &out) const;
+	bool Unpack(const char *begin, const char *end);
+
 
 private:
-	void LoadData(const std::string &data);
+	// Parse the given text. Each token is found in place and then copied into
+	// its node, so the text does not need to outlive this call.
+	void LoadData(const char *begin, const char *end);
+
+	static void PackNode(const DataNode &node, std::string &out);
+	static bool UnpackNode(DataNode &node, const char *&pos, const char *end);
 
 
 private:
 	// This is the container for all DataNodes in this file.
 	DataNode root;
+	bool hasWarnings = false;
 };
 
 
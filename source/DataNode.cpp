@@ -20,9 +20,57 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <limits>
 
 using namespace std;
 
+namespace {
+	// Convert a token that is known to be a number to its value.
+	double Parse(const char *it)
+	{
+		// Check for leading sign.
+		double sign = (*it == '-') ? -1. : 1.;
+		it += (*it == '-' || *it == '+');
+
+		// Digits before the decimal point.
+		int64_t value = 0;
+		while(*it >= '0' && *it <= '9')
+			value = (value * 10) + (*it++ - '0');
+
+		// Digits after the decimal point (if any).
+		int64_t power = 0;
+		if(*it == '.')
+		{
+			++it;
+			while(*it >= '0' && *it <= '9')
+			{
+				value = (value * 10) + (*it++ - '0');
+				--power;
+			}
+		}
+
+		// Exponent.
+		if(*it == 'e' || *it == 'E')
+		{
+			++it;
+			int64_t sign = (*it == '-') ? -1 : 1;
+			it += (*it == '-' || *it == '+');
+
+			int64_t exponent = 0;
+			while(*it >= '0' && *it <= '9')
+				exponent = (exponent * 10) + (*it++ - '0');
+
+			power += sign * exponent;
+		}
+
+		// Compose the return value. Zero stays zero no matter how large the
+		// exponent is, so that no number is ever NaN.
+		if(!value)
+			return copysign(0., sign);
+		return copysign(value * pow(10., power), sign);
+	}
+}
+
 
 
 // Construct a DataNode and remember what its parent is.
@@ -39,7 +87,7 @@ DataNode::DataNode(const DataNode *parent) noexcept(false)
 
 // Copy constructor.
 DataNode::DataNode(const DataNode &other)
-	: children(other.children), tokens(other.tokens), lineNumber(other.lineNumber)
+	: children(other.children), tokens(other.tokens), values(other.values), lineNumber(other.lineNumber)
 {
 	Reparent();
 }
@@ -51,6 +99,7 @@ DataNode &DataNode::operator=(const DataNode &other)
 {
 	children = other.children;
 	tokens = other.tokens;
+	values = other.values;
 	lineNumber = other.lineNumber;
 	Reparent();
 	return *this;
@@ -59,7 +108,8 @@ DataNode &DataNode::operator=(const DataNode &other)
 
 
 DataNode::DataNode(DataNode &&other) noexcept
-	: children(std::move(other.children)), tokens(std::move(other.tokens)), lineNumber(std::move(other.lineNumber))
+	: children(std::move(other.children)), tokens(std::move(other.tokens)), values(std::move(other.values)),
+		lineNumber(std::move(other.lineNumber))
 {
 	Reparent();
 }
@@ -70,6 +120,7 @@ DataNode &DataNode::operator=(DataNode &&other) noexcept
 {
 	children.swap(other.children);
 	tokens.swap(other.tokens);
+	values.swap(other.values);
 	lineNumber = std::move(other.lineNumber);
 	Reparent();
 	return *this;
@@ -108,10 +159,10 @@ double DataNode::Value(int index) const
 	// Check for empty strings and out-of-bounds indices.
 	if(static_cast<size_t>(index) >= tokens.size() || tokens[index].empty())
 		PrintTrace("Error: Requested token index (" + to_string(index) + ") is out of bounds:");
-	else if(!IsNumber(tokens[index]))
+	else if(std::isnan(values[index]))
 		PrintTrace("Error: Cannot convert value \"" + tokens[index] + "\" to a number:");
 	else
-		return Value(tokens[index]);
+		return values[index];
 
 	return 0.;
 }
@@ -127,45 +178,7 @@ double DataNode::Value(const string &token)
 		Logger::LogError("Cannot convert value \"" + token + "\" to a number.");
 		return 0.;
 	}
-	const char *it = token.c_str();
-
-	// Check for leading sign.
-	double sign = (*it == '-') ? -1. : 1.;
-	it += (*it == '-' || *it == '+');
-
-	// Digits before the decimal point.
-	int64_t value = 0;
-	while(*it >= '0' && *it <= '9')
-		value = (value * 10) + (*it++ - '0');
-
-	// Digits after the decimal point (if any).
-	int64_t power = 0;
-	if(*it == '.')
-	{
-		++it;
-		while(*it >= '0' && *it <= '9')
-		{
-			value = (value * 10) + (*it++ - '0');
-			--power;
-		}
-	}
-
-	// Exponent.
-	if(*it == 'e' || *it == 'E')
-	{
-		++it;
-		int64_t sign = (*it == '-') ? -1 : 1;
-		it += (*it == '-' || *it == '+');
-
-		int64_t exponent = 0;
-		while(*it >= '0' && *it <= '9')
-			exponent = (exponent * 10) + (*it++ - '0');
-
-		power += sign * exponent;
-	}
-
-	// Compose the return value.
-	return copysign(value * pow(10., power), sign);
+	return Parse(token.c_str());
 }
 
 
@@ -178,7 +191,7 @@ bool DataNode::IsNumber(int index) const
 	if(static_cast<size_t>(index) >= tokens.size() || tokens[index].empty())
 		return false;
 
-	return IsNumber(tokens[index]);
+	return !std::isnan(values[index]);
 }
 
 
@@ -336,3 +349,16 @@ void DataNode::Reparent() noexcept
 		child.Reparent();
 	}
 }
+
+
+
+// Add a token to the end of this node, and find its numeric value.
+void DataNode::AddToken(const char *text, size_t length)
+{
+	tokens.emplace_back(text, length);
+	const string &token = tokens.back();
+	if(!token.empty() && IsNumber(token))
+		values.push_back(Parse(token.c_str()));
+	else
+		values.push_back(numeric_limits<double>::quiet_NaN());
+}
@@ -76,6 +76,8 @@ public:
 private:
 	// Adjust the parent pointers when a copy is made of a DataNode.
 	void Reparent() noexcept;
+	// Add a token to the end of this node, and find its numeric value.
+	void AddToken(const char *text, size_t length);
 
 
 private:
@@ -83,6 +85,10 @@ private:
 	std::list<DataNode> children;
 	// These are the tokens found in this particular line of the data file.
 	std::vector<std::string> tokens;
+	// The value of each token that is a number, or NaN for any other token.
+	// Most numbers are asked for more than once, so each is parsed only once,
+	// when the tokens are read.
+	std::vector<double> values;
 	// The parent pointer is used only for printing stack traces.
 	const DataNode *parent = nullptr;
 	// The line number in the given file that produced this node.
@@ -0,0 +1,82 @@
+/* DecisionScheduler.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DecisionScheduler.h"
+
+#include "Ship.h"
+
+using namespace std;
+
+namespace {
+	// The number of decisions that may be made in one step, if any ship would
+	// have to wait to stay within it. A typical decision takes less than a
+	// microsecond, and a busy system needs a few dozen of them in each step.
+	const int STEP_BUDGET = 200;
+	// Ships this close to the player's flagship never wait.
+	const double PRIORITY_RANGE = 3000.;
+	// The most steps that a decision may be put off for.
+	const int MAX_WAIT = 30;
+	const int MAX_URGENT_WAIT = 5;
+	// How often to forget about decisions that were never asked for again,
+	// e.g. because the ship that was waiting has been destroyed.
+	const int CLEANUP_PERIOD = 600;
+}
+
+
+
+// Begin a new step. Ships in the given system that are near the given point
+// (i.e. the player's flagship) are never told to wait.
+void DecisionScheduler::BeginStep(const System *system, const Point &center)
+{
+	this->system = system;
+	this->center = center;
+	used = 0;
+
+	++step;
+	if(!(step % CLEANUP_PERIOD))
+		for(auto it = waiting.begin(); it != waiting.end(); )
+		{
+			if(step - it->second > CLEANUP_PERIOD)
+				it = waiting.erase(it);
+			else
+				++it;
+		}
+}
+
+
+
+// Check whether the given ship may make the given decision now, and if so,
+// count it against this step's budget. If not, the ship should keep acting on
+// its previous decision, and ask again in a later step. Urgent decisions are
+// put off for fewer steps.
+bool DecisionScheduler::Allow(const Ship &ship, Task task, bool isUrgent)
+{
+	auto key = make_pair(&ship, static_cast<int>(task));
+	bool isAllowed = (used < STEP_BUDGET || ship.IsYours()
+		|| (ship.GetSystem() == system && ship.Position().Distance(center) < PRIORITY_RANGE));
+
+	auto it = waiting.find(key);
+	if(!isAllowed)
+	{
+		if(it == waiting.end())
+			it = waiting.emplace(key, step).first;
+		isAllowed = (step - it->second >= (isUrgent ? MAX_URGENT_WAIT : MAX_WAIT));
+	}
+
+	if(isAllowed && it != waiting.end())
+		waiting.erase(it);
+	used += isAllowed;
+	return isAllowed;
+}
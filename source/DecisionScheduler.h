@@ -0,0 +1,69 @@
+/* DecisionScheduler.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DECISION_SCHEDULER_H_
+#define DECISION_SCHEDULER_H_
+
+#include "Point.h"
+
+#include <map>
+#include <utility>
+
+class Ship;
+class System;
+
+
+
+// Class for spreading the AI's most expensive decisions over several steps, so
+// that the time the AI takes does not spike when many ships need to make them
+// at once (for example, when several fleets arrive in the player's system).
+// The number of these decisions made in each step is limited by a budget.
+// Ships near the player, and the player's own ships, may always make them.
+// Other ships may be told to wait once the budget is used up, but only for a
+// few steps, so no decision is put off for long. The budget is a count rather
+// than a measured time, so that the game plays out the same way every time
+// given the same random seed, no matter how fast the computer is.
+class DecisionScheduler {
+public:
+	enum Task {FIND_TARGET, FIND_NON_HOSTILE_TARGET, ASK_FOR_HELP, SELECT_ROUTE, FIND_ASTEROID, TASK_COUNT};
+
+
+public:
+	// Begin a new step. Ships in the given system that are near the given
+	// point (i.e. the player's flagship) are never told to wait.
+	void BeginStep(const System *system, const Point &center);
+
+	// Check whether the given ship may make the given decision now, and if so,
+	// count it against this step's budget. If not, the ship should keep acting
+	// on its previous decision, and ask again in a later step. Urgent decisions
+	// are put off for fewer steps.
+	bool Allow(const Ship &ship, Task task, bool isUrgent = false);
+
+
+private:
+	// The step that each waiting decision was first put off in.
+	std::map<std::pair<const Ship *, int>, int> waiting;
+
+	int step = 0;
+	// The number of decisions made so far in this step.
+	int used = 0;
+
+	const System *system = nullptr;
+	Point center;
+};
+
+
+
+#endif
@@ -23,6 +23,9 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "System.h"
 #include "Wormhole.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace std;
 
 
@@ -84,7 +87,24 @@ DistanceMap::DistanceMap(const Ship &ship, const System *destination)
 	if(!source || !destination)
 		return;
 
-	Init(&ship);
+	Init(&ship, true);
+}
+
+
+
+// Calculate the path from one system to another, with the same travel
+// options as the second constructor. A search for a path between two
+// systems is guided toward the source system by how far away it is, so
+// it examines fewer systems, unless told not to use that estimate.
+DistanceMap::DistanceMap(const System *source, const System *destination, WormholeStrategy wormholeStrategy,
+		bool useJumpDrive, bool useEstimate)
+	: source(source), center(destination), wormholeStrategy(wormholeStrategy),
+			jumpFuel(useJumpDrive ? 200 : 0), jumpRange(useJumpDrive ? 100. : 0.)
+{
+	if(!source || !destination)
+		return;
+
+	Init(nullptr, useEstimate);
 }
 
 
@@ -92,7 +112,7 @@ DistanceMap::DistanceMap(const Ship &ship, const System *destination)
 // Find out if the given system is reachable.
 bool DistanceMap::HasRoute(const System *system) const
 {
-	return route.count(system);
+	return Find(system);
 }
 
 
@@ -100,8 +120,8 @@ bool DistanceMap::HasRoute(const System *system) const
 // Find out how many days away the given system is.
 int DistanceMap::Days(const System *system) const
 {
-	auto it = route.find(system);
-	return (it == route.end() ? -1 : it->second.days);
+	const Edge *edge = Find(system);
+	return (edge ? edge->days : -1);
 }
 
 
@@ -109,8 +129,8 @@ int DistanceMap::Days(const System *system) const
 // Starting in the given system, what is the next system along the route?
 const System *DistanceMap::Route(const System *system) const
 {
-	auto it = route.find(system);
-	return (it == route.end() ? nullptr : it->second.next);
+	const Edge *edge = Find(system);
+	return (edge ? edge->next : nullptr);
 }
 
 
@@ -136,11 +156,11 @@ const System *DistanceMap::End() const
 
 int DistanceMap::RequiredFuel(const System *system1, const System *system2) const
 {
-	auto it1 = route.find(system1);
-	auto it2 = route.find(system2);
-	if(it1 == route.end() || it2 == route.end())
+	const Edge *edge1 = Find(system1);
+	const Edge *edge2 = Find(system2);
+	if(!edge1 || !edge2)
 		return -1;
-	return abs(it1->second.fuel - it2->second.fuel);
+	return abs(edge1->fuel - edge2->fuel);
 }
 
 
@@ -168,15 +188,87 @@ bool DistanceMap::Edge::operator<(const Edge &other) const
 
 
 
+// Sorting operator for the search queue, which prioritizes edges by the
+// total fuel and days that their routes can be expected to take. With no
+// estimate, this is the same as comparing the edges themselves.
+bool DistanceMap::Farther::operator()(const Edge &a, const Edge &b) const
+{
+	int aFuel = a.fuel + a.fuelLeft;
+	int bFuel = b.fuel + b.fuelLeft;
+	if(aFuel != bFuel)
+		return (aFuel > bFuel);
+
+	int aDays = a.days + a.daysLeft;
+	int bDays = b.days + b.daysLeft;
+	if(aDays != bDays)
+		return (aDays > bDays);
+
+	return (a.danger > b.danger);
+}
+
+
+
+// Every step of a route (other than through a wormhole) covers at most the
+// given distance on the map. A wormhole may cover any distance, so a route
+// may also be as short as the distance to the nearest wormhole, plus one day,
+// plus the distance from the nearest wormhole to the source. Both bounds can
+// only shrink by one day per step along a route, so a search using them finds
+// the same best route as one that does not.
+DistanceMap::Estimate::Estimate(const System &source, WormholeStrategy wormholeStrategy, double longestStep)
+	: source(&source)
+{
+	// Make sure that a step that is exactly the longest length is never
+	// counted as more than one step because of rounding.
+	this->longestStep = longestStep * (1. + 1e-9) + 1e-9;
+
+	if(wormholeStrategy != WormholeStrategy::NONE)
+		wormholeToSource = source.WormholeDistance();
+}
+
+
+
+bool DistanceMap::Estimate::IsActive() const
+{
+	return source && longestStep > 1e-6;
+}
+
+
+
+// Get the least number of days it could take to get from the given system
+// to the source, and the least number of those days that do not use a
+// wormhole.
+void DistanceMap::Estimate::Get(const System &from, int &days, int &jumps) const
+{
+	days = Steps(from.Position().Distance(source->Position()));
+	jumps = days;
+	if(wormholeToSource < 0. || from.WormholeDistance() < 0.)
+		return;
+
+	int wormholeJumps = Steps(from.WormholeDistance()) + Steps(wormholeToSource);
+	days = min(days, wormholeJumps + 1);
+	jumps = min(jumps, wormholeJumps);
+}
+
+
+
+// Get the number of steps of the longest length needed to cover the given
+// distance.
+int DistanceMap::Estimate::Steps(double distance) const
+{
+	return ceil(distance / longestStep);
+}
+
+
+
 // Depending on the capabilities of the given ship, use hyperspace paths,
 // jump drive paths, or both to find the shortest route. Bail out if the
 // source system or the maximum count is reached.
-void DistanceMap::Init(const Ship *ship)
+void DistanceMap::Init(const Ship *ship, bool useEstimate)
 {
 	if(!center)
 		return;
 
-	route[center] = Edge();
+	Record(*center, Edge());
 	if(!maxDistance)
 		return;
 
@@ -209,6 +301,13 @@ void DistanceMap::Init(const Ship *ship)
 		}
 	}
 
+	// When looking for a route to a particular system, search toward it first.
+	if(useEstimate && source)
+	{
+		double longestStep = max(hyperspaceFuel ? System::LongestLink() : 0., jumpFuel ? System::LongestJump() : 0.);
+		estimate = Estimate(*source, wormholeStrategy, longestStep);
+	}
+
 	// Find the route with lowest fuel use. If multiple routes use the same fuel,
 	// choose the one with the fewest jumps (i.e. using jump drive rather than
 	// hyperdrive). If multiple routes have the same fuel and the same number of
@@ -290,11 +389,24 @@ bool DistanceMap::Propagate(Edge edge, bool useJump)
 
 
 
+// Get the best path found so far to the given system, if any.
+const DistanceMap::Edge *DistanceMap::Find(const System *system) const
+{
+	if(!system)
+		return nullptr;
+	unsigned index = system->Index();
+	if(index >= slots.size() || slots[index] < 0)
+		return nullptr;
+	return &route[slots[index]].second;
+}
+
+
+
 // Check if we already have a better path to the given system.
 bool DistanceMap::HasBetter(const System &to, const Edge &edge)
 {
-	auto it = route.find(&to);
-	return (it != route.end() && !(it->second < edge));
+	const Edge *existing = Find(&to);
+	return (existing && !(*existing < edge));
 }
 
 
@@ -304,14 +416,38 @@ void DistanceMap::Add(const System &to, Edge edge)
 {
 	// This is the best path we have found so far to this system, but it is
 	// conceivable that a better one will be found.
-	route[&to] = edge;
+	Record(to, edge);
 	edge.next = &to;
+	if(estimate.IsActive())
+	{
+		int jumps = 0;
+		estimate.Get(to, edge.daysLeft, jumps);
+		edge.fuelLeft = jumps * (hyperspaceFuel && jumpFuel ? min(hyperspaceFuel, jumpFuel)
+			: max(hyperspaceFuel, jumpFuel));
+	}
 	if(maxDistance < 0 || edge.days < maxDistance)
 		edges.emplace(edge);
 }
 
 
 
+// Store the given path to the given system, replacing any previous one.
+void DistanceMap::Record(const System &to, const Edge &edge)
+{
+	unsigned index = to.Index();
+	if(index >= slots.size())
+		slots.resize(index + 1, -1);
+	if(slots[index] < 0)
+	{
+		slots[index] = route.size();
+		route.emplace_back(&to, edge);
+	}
+	else
+		route[slots[index]].second = edge;
+}
+
+
+
 // Check whether the given link is travelable. If no player was given in the
 // constructor then this is always true; otherwise, the player must know
 // that the given link exists.
@@ -18,10 +18,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "WormholeStrategy.h"
 
-#include <map>
 #include <queue>
 #include <set>
 #include <utility>
+#include <vector>
 
 class PlayerInfo;
 class Ship;
@@ -51,6 +51,12 @@ public:
 	// ship will use a jump drive or hyperdrive depending on what it has. The
 	// pathfinding will stop once a path to the destination is found.
 	DistanceMap(const Ship &ship, const System *destination);
+	// Calculate the path from one system to another, with the same travel
+	// options as the second constructor. A search for a path between two
+	// systems is guided toward the source system by how far away it is, so
+	// it examines fewer systems, unless told not to use that estimate.
+	DistanceMap(const System *source, const System *destination, WormholeStrategy wormholeStrategy,
+			bool useJumpDrive, bool useEstimate = true);
 
 	// Find out if the given system is reachable.
 	bool HasRoute(const System *system) const;
@@ -84,6 +90,43 @@ private:
 		int fuel = 0;
 		int days = 0;
 		double danger = 0.;
+		// When searching for a path to a source system, the least fuel and
+		// days it could possibly take to get from "next" to the source.
+		int fuelLeft = 0;
+		int daysLeft = 0;
+	};
+
+	// Sorting operator for the search queue, which prioritizes edges by the
+	// total fuel and days that their routes can be expected to take.
+	class Farther {
+	public:
+		bool operator()(const Edge &a, const Edge &b) const;
+	};
+
+	// A lower bound on how far a route to the source system must travel,
+	// based on the straight-line distances on the map.
+	class Estimate {
+	public:
+		Estimate() = default;
+		Estimate(const System &source, WormholeStrategy wormholeStrategy, double longestStep);
+
+		bool IsActive() const;
+		// Get the least number of days it could take to get from the given
+		// system to the source, and the least number of those days that do
+		// not use a wormhole.
+		void Get(const System &from, int &days, int &jumps) const;
+
+	private:
+		// Get the number of steps of the longest length needed to cover
+		// the given distance.
+		int Steps(double distance) const;
+
+	private:
+		const System *source = nullptr;
+		double longestStep = 0.;
+		// How close the source is to any system that a wormhole leads to or
+		// from, or -1 if wormholes are not used.
+		double wormholeToSource = -1.;
 	};
 
 
@@ -91,13 +134,17 @@ private:
 	// Depending on the capabilities of the given ship, use hyperspace paths,
 	// jump drive paths, or both to find the shortest route. Bail out if the
 	// source system or the maximum count is reached.
-	void Init(const Ship *ship = nullptr);
+	void Init(const Ship *ship = nullptr, bool useEstimate = false);
 	// Add the given links to the map. Return false if an end condition is hit.
 	bool Propagate(Edge edge, bool useJump);
+	// Get the best path found so far to the given system, if any.
+	const Edge *Find(const System *system) const;
 	// Check if we already have a better path to the given system.
 	bool HasBetter(const System &to, const Edge &edge);
 	// Add the given path to the record.
 	void Add(const System &to, Edge edge);
+	// Store the given path to the given system, replacing any previous one.
+	void Record(const System &to, const Edge &edge);
 	// Check whether the given link is travelable. If no player was given in the
 	// constructor then this is always true; otherwise, the player must know
 	// that the given link exists.
@@ -105,10 +152,18 @@ private:
 
 
 private:
-	std::map<const System *, Edge> route;
+	// The best path to each system that has been reached, in the order they
+	// were reached. The entry for each system is found using its index, so
+	// that no search is needed.
+	std::vector<std::pair<const System *, Edge>> route;
+	// Where each system's path is in the list above, indexed by the system's
+	// Index(), or -1 if it has not been reached. This only extends as far as
+	// the largest index of a system that has been reached.
+	std::vector<int> slots;
 
 	// Variables only used during construction:
-	std::priority_queue<Edge> edges;
+	std::priority_queue<Edge, std::vector<Edge>, Farther> edges;
+	Estimate estimate;
 	const PlayerInfo *player = nullptr;
 	const System *source = nullptr;
 	const System *center = nullptr;
@@ -0,0 +1,272 @@
+/* DistanceTable.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DistanceTable.h"
+
+#include "DistanceCalculationSettings.h"
+#include "DistanceMap.h"
+#include "GameData.h"
+#include "Planet.h"
+#include "StellarObject.h"
+#include "System.h"
+#include "Wormhole.h"
+
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+namespace {
+	// Table entries for systems that cannot be reached, and for ones that are
+	// this many days away or more, so their actual distance is not stored.
+	const uint8_t UNREACHABLE = 255;
+	const uint8_t TOO_FAR = 254;
+	// The table has an entry for every pair of systems, so it is only built if
+	// there are no more than this many systems (making it at most 4 MB). With
+	// more systems than that, every distance is found with a DistanceMap.
+	const size_t MAX_SYSTEMS = 2048;
+
+	// The fuel costs that a DistanceMap uses when it is not given a ship.
+	const int HYPERSPACE_FUEL = 100;
+	const int JUMP_FUEL = 200;
+	const double JUMP_RANGE = 100.;
+
+	mutex tablesMutex;
+	map<pair<WormholeStrategy, bool>, shared_ptr<DistanceTable>> tables;
+}
+
+
+
+// Get the game's table for the given travel options. If there is none, a
+// new one is begun in the background, and returned right away.
+shared_ptr<const DistanceTable> DistanceTable::Get(const DistanceCalculationSettings &settings)
+{
+	lock_guard<mutex> lock(tablesMutex);
+	shared_ptr<DistanceTable> &table = tables[make_pair(settings.WormholeStrat(), settings.AssumesJumpDrive())];
+	if(!table)
+	{
+		table = make_shared<DistanceTable>(GameData::Systems(), settings.WormholeStrat(), settings.AssumesJumpDrive());
+		// The table is only discarded after its thread has been stopped.
+		table->builder = thread(&DistanceTable::Build, table.get());
+	}
+	return table;
+}
+
+
+
+// Get the number of days from one system to another, or -1 if there is no
+// route. If the game's table does not have the answer yet, a DistanceMap is
+// used to find it.
+int DistanceTable::Days(const System *center, const System *system, const DistanceCalculationSettings &settings)
+{
+	int days = -1;
+	if(Get(settings)->Find(center, system, days))
+		return days;
+	return DistanceMap(center, settings.WormholeStrat(), settings.AssumesJumpDrive()).Days(system);
+}
+
+
+
+// Get the number of days from one system to each of the given systems. If the
+// game's table does not have all of the answers yet, a single DistanceMap is
+// used to find the rest.
+vector<int> DistanceTable::Days(const System *center, const vector<const System *> &systems,
+	const DistanceCalculationSettings &settings)
+{
+	shared_ptr<const DistanceTable> table = Get(settings);
+	unique_ptr<DistanceMap> distance;
+	vector<int> result(systems.size(), -1);
+	for(size_t i = 0; i < systems.size(); ++i)
+		if(!table->Find(center, systems[i], result[i]))
+		{
+			if(!distance)
+				distance.reset(new DistanceMap(center, settings.WormholeStrat(), settings.AssumesJumpDrive()));
+			result[i] = distance->Days(systems[i]);
+		}
+	return result;
+}
+
+
+
+// Discard all of the game's tables, because the systems have changed.
+void DistanceTable::Clear()
+{
+	lock_guard<mutex> lock(tablesMutex);
+	// Stop each table's thread now, rather than whenever the last copy of the
+	// table is released.
+	for(auto &it : tables)
+		it.second->Cancel();
+	tables.clear();
+}
+
+
+
+// Copy the links between the given systems that can be used with the given
+// travel options. The table is empty until it is built.
+DistanceTable::DistanceTable(const Set<System> &systems, WormholeStrategy wormholeStrategy, bool useJumpDrive)
+	: isCanceled(false)
+{
+	for(const auto &it : systems)
+	{
+		unsigned index = it.second.Index();
+		if(index >= positions.size())
+			positions.resize(index + 1, -1);
+		positions[index] = count++;
+	}
+	if(count > MAX_SYSTEMS)
+		return;
+
+	// These are the same ways of traveling that a DistanceMap would consider.
+	links.resize(count);
+	for(const auto &it : systems)
+	{
+		const System &system = it.second;
+		vector<Link> &out = links[Position(&system)];
+		for(const System *link : system.Links())
+			if(Position(link) >= 0)
+				out.emplace_back(Position(link), HYPERSPACE_FUEL);
+		if(useJumpDrive)
+			for(const System *link : system.JumpNeighbors(JUMP_RANGE))
+				if(Position(link) >= 0)
+					out.emplace_back(Position(link), JUMP_FUEL);
+		if(wormholeStrategy != WormholeStrategy::NONE)
+			for(const StellarObject &object : system.Objects())
+				if(object.HasSprite() && object.HasValidPlanet() && object.GetPlanet()->IsWormhole()
+					&& (object.GetPlanet()->IsUnrestricted() || wormholeStrategy == WormholeStrategy::ALL))
+				{
+					const System *link = &object.GetPlanet()->GetWormhole()->WormholeDestination(system);
+					if(Position(link) >= 0)
+						out.emplace_back(Position(link), 0);
+				}
+	}
+
+	days.resize(count * count, UNREACHABLE);
+	isRowReady.reset(new atomic<bool>[count]);
+	for(size_t i = 0; i < count; ++i)
+		isRowReady[i].store(false, memory_order_relaxed);
+}
+
+
+
+// Stop the thread building this table, if there is one.
+DistanceTable::~DistanceTable()
+{
+	Cancel();
+}
+
+
+
+// Fill in the table, one row at a time. This may be done in another thread
+// while the table is being used.
+void DistanceTable::Build()
+{
+	if(days.empty())
+		return;
+	for(size_t row = 0; row < count; ++row)
+	{
+		if(isCanceled.load(memory_order_relaxed))
+			return;
+		BuildRow(row);
+		isRowReady[row].store(true, memory_order_release);
+	}
+}
+
+
+
+// Stop building the table, because it is no longer needed, and wait for
+// the thread that is building it to finish.
+void DistanceTable::Cancel()
+{
+	isCanceled.store(true, memory_order_relaxed);
+	if(builder.joinable())
+		builder.join();
+}
+
+
+
+// Find the number of days from the center to the given system, or -1 if
+// there is no route between them. Return false if this table does not have
+// the answer, because its row is not built yet, either system is not in
+// the table, the route is too long to store, or there are too many systems
+// for the table to be built at all.
+bool DistanceTable::Find(const System *center, const System *system, int &days) const
+{
+	if(this->days.empty())
+		return false;
+	int row = Position(center);
+	int column = Position(system);
+	if(row < 0 || column < 0 || !isRowReady[row].load(memory_order_acquire))
+		return false;
+
+	uint8_t value = this->days[row * count + column];
+	if(value == TOO_FAR)
+		return false;
+	days = (value == UNREACHABLE ? -1 : value);
+	return true;
+}
+
+
+
+// Get the table's row and column number for the given system, or -1.
+int DistanceTable::Position(const System *system) const
+{
+	if(!system || system->Index() >= positions.size())
+		return -1;
+	return positions[system->Index()];
+}
+
+
+
+// Find the days to each system from the one with the given position.
+void DistanceTable::BuildRow(unsigned row)
+{
+	// Like a DistanceMap, find the routes that use the least fuel, and of
+	// those, the ones that take the fewest days. (A DistanceMap also compares
+	// how dangerous the routes are, but that never changes how many days the
+	// best route takes.)
+	using Cost = pair<int, int>;
+	using Entry = pair<Cost, unsigned>;
+	vector<Cost> best(count, Cost(numeric_limits<int>::max(), numeric_limits<int>::max()));
+	priority_queue<Entry, vector<Entry>, greater<Entry>> queue;
+	best[row] = Cost(0, 0);
+	queue.emplace(best[row], row);
+	while(!queue.empty())
+	{
+		Entry top = queue.top();
+		queue.pop();
+		if(best[top.second] < top.first)
+			continue;
+
+		for(const Link &link : links[top.second])
+		{
+			Cost cost(top.first.first + link.fuel, top.first.second + 1);
+			if(cost < best[link.to])
+			{
+				best[link.to] = cost;
+				queue.emplace(cost, link.to);
+			}
+		}
+	}
+
+	uint8_t *out = &days[row * count];
+	for(size_t i = 0; i < count; ++i)
+		if(best[i].second != numeric_limits<int>::max())
+			out[i] = best[i].second < TOO_FAR ? best[i].second : TOO_FAR;
+}
@@ -0,0 +1,122 @@
+/* DistanceTable.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DISTANCE_TABLE_H_
+#define DISTANCE_TABLE_H_
+
+#include "Set.h"
+#include "WormholeStrategy.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+class DistanceCalculationSettings;
+class System;
+
+
+
+// A table of how many days it takes to travel from every system to every other
+// system, for one choice of whether to use a jump drive and which wormholes to
+// use. Each entry is what a DistanceMap centered on the first system, with no
+// limits, would give as the distance to the second one, but finding it is just
+// a lookup. The links between the systems are copied when the table is
+// created, so it can be filled in by another thread, one row at a time, while
+// the systems themselves change; rows that are not yet filled in give no
+// answer. A table for a very large number of systems is never filled in,
+// because it would take up too much memory.
+//
+// The game keeps one table for each travel option that it has been asked
+// about, for the systems in GameData. Each of those tables owns the thread that
+// builds it. They must be cleared whenever the systems or their links change,
+// and are then built again in the background when next needed.
+class DistanceTable {
+public:
+	// Get the game's table for the given travel options. If there is none, a
+	// new one is begun in the background, and returned right away.
+	static std::shared_ptr<const DistanceTable> Get(const DistanceCalculationSettings &settings);
+	// Get the number of days from one system to another, or -1 if there is no
+	// route. If the game's table does not have the answer yet, a DistanceMap is
+	// used to find it.
+	static int Days(const System *center, const System *system, const DistanceCalculationSettings &settings);
+	// Get the number of days from one system to each of the given systems. If
+	// the game's table does not have all of the answers yet, a single
+	// DistanceMap is used to find the rest.
+	static std::vector<int> Days(const System *center, const std::vector<const System *> &systems,
+		const DistanceCalculationSettings &settings);
+	// Discard all of the game's tables, because the systems have changed.
+	static void Clear();
+
+
+public:
+	// Copy the links between the given systems that can be used with the given
+	// travel options. The table is empty until it is built.
+	DistanceTable(const Set<System> &systems, WormholeStrategy wormholeStrategy, bool useJumpDrive);
+	// Stop the thread building this table, if there is one.
+	~DistanceTable();
+
+	// Fill in the table, one row at a time. This may be done in another thread
+	// while the table is being used.
+	void Build();
+	// Stop building the table, because it is no longer needed, and wait for
+	// the thread that is building it to finish.
+	void Cancel();
+
+	// Find the number of days from the center to the given system, or -1 if
+	// there is no route between them. Return false if this table does not have
+	// the answer, because its row is not built yet, either system is not in
+	// the table, the route is too long to store, or there are too many systems
+	// for the table to be built at all.
+	bool Find(const System *center, const System *system, int &days) const;
+
+
+private:
+	// A way to get from one system to another in one day, and its fuel cost.
+	class Link {
+	public:
+		Link(unsigned to, int fuel) : to(to), fuel(fuel) {}
+
+		unsigned to;
+		int fuel;
+	};
+
+
+private:
+	// Get the table's row and column number for the given system, or -1.
+	int Position(const System *system) const;
+	// Find the days to each system from the one with the given position.
+	void BuildRow(unsigned row);
+
+
+private:
+	// Each system's position in the table, indexed by System::Index().
+	std::vector<int> positions;
+	// The links out of each system, by position.
+	std::vector<std::vector<Link>> links;
+	std::size_t count = 0;
+
+	// The days from each system (the row) to each other system (the column).
+	std::vector<uint8_t> days;
+	std::unique_ptr<std::atomic<bool>[]> isRowReady;
+	std::atomic<bool> isCanceled;
+	// The thread building this table in the background, if any.
+	std::thread builder;
+};
+
+
+
+#endif
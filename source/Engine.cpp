@@ -23,6 +23,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DamageDealt.h"
 #include "DamageProfile.h"
 #include "Effect.h"
+#include "Files.h"
 #include "FillShader.h"
 #include "Fleet.h"
 #include "Flotsam.h"
@@ -38,6 +39,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Logger.h"
 #include "MapPanel.h"
 #include "Mask.h"
+#include "MaskManager.h"
 #include "Messages.h"
 #include "Minable.h"
 #include "Mission.h"
@@ -67,6 +69,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SystemEntry.h"
 #include "Test.h"
 #include "TestContext.h"
+#include "Tracer.h"
 #include "Visual.h"
 #include "Weather.h"
 #include "Wormhole.h"
@@ -79,6 +82,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 using namespace std;
 
 namespace {
+	// The number of projectiles that each worker thread checks for collisions
+	// at a time.
+	const size_t COLLISION_CHUNK = 64;
+
 	int RadarType(const Ship &ship, int step)
 	{
 		if(ship.GetPersonality().IsTarget() && !ship.IsDestroyed())
@@ -300,6 +307,9 @@ Engine::~Engine()
 	}
 	condition.notify_all();
 	calcThread.join();
+
+	if(Preferences::Has("Show step timing") && profile.Steps())
+		profile.Save(Files::Config() + "step times.csv");
 }
 
 
@@ -476,6 +486,7 @@ void Engine::Place(const list<NPC> &npcs, shared_ptr<Ship> flagship)
 // Wait for the previous calculations (if any) to be done.
 void Engine::Wait()
 {
+	Tracer::Zone zone("Engine::Wait");
 	unique_lock<mutex> lock(swapMutex);
 	condition.wait(lock, [this] { return hasFinishedCalculating; });
 	drawTickTock = calcTickTock;
@@ -490,6 +501,12 @@ void Engine::Step(bool isActive)
 	eventQueue.clear();
 
 	// The calculation thread was paused by MainPanel before calling this function, so it is safe to access things.
+	// That includes putting in place the collision masks of any sprites that were loaded during the last step.
+	GameData::GetMaskManager().UpdateMasks();
+	if(Preferences::Has("Show step timing"))
+		for(int i = 0; i <= StepProfile::PHASE_COUNT; ++i)
+			phaseTimes[i] = profile.Average(i);
+
 	const shared_ptr<Ship> flagship = player.FlagshipPtr();
 	const StellarObject *object = player.GetStellarObject();
 	if(object)
@@ -969,6 +986,32 @@ void Engine::Go()
 
 
 
+// Seed the random number generator used by the calculation thread before
+// its next step, so that a run of the simulation can be reproduced.
+void Engine::Seed(uint64_t seed)
+{
+	unique_lock<mutex> lock(swapMutex);
+	this->seed = seed;
+	hasSeed = true;
+}
+
+
+
+// Get the timing of each phase of the most recent steps.
+const StepProfile &Engine::Profile() const
+{
+	return profile;
+}
+
+
+
+const AI &Engine::GetAI() const
+{
+	return ai;
+}
+
+
+
 // Pass the list of game events to MainPanel for handling by the player, and any
 // UI element generation.
 list<ShipEvent> &Engine::Events()
@@ -981,6 +1024,7 @@ list<ShipEvent> &Engine::Events()
 // Draw a frame.
 void Engine::Draw() const
 {
+	Tracer::Zone zone("Engine::Draw");
 	GameData::Background().Draw(center, centerVelocity, zoom, (player.Flagship() ?
 		player.Flagship()->GetSystem() : player.GetSystem()));
 	static const Set<Color> &colors = GameData::Colors();
@@ -1135,6 +1179,18 @@ void Engine::Draw() const
 		font.Draw(loadString,
 			Point(-10 - font.Width(loadString), Screen::Height() * -.5 + 5.), color);
 	}
+	if(Preferences::Has("Show step timing"))
+	{
+		// List the average time of each phase of the step, below the CPU load.
+		Color color = *colors.Get("medium");
+		Point point(-10., Screen::Height() * -.5 + 25.);
+		for(int i = 0; i <= StepProfile::PHASE_COUNT; ++i)
+		{
+			string line = StepProfile::Name(i) + ": " + Format::Decimal(phaseTimes[i], 2) + " ms";
+			font.Draw(line, point - Point(font.Width(line), 0.), color);
+			point.Y() += 20.;
+		}
+	}
 }
 
 
@@ -1363,6 +1419,7 @@ void Engine::EnterSystem()
 // Thread entry point.
 void Engine::ThreadEntryPoint()
 {
+	Tracer::SetThreadName("engine calculation");
 	while(true)
 	{
 		{
@@ -1371,6 +1428,14 @@ void Engine::ThreadEntryPoint()
 
 			if(terminate)
 				break;
+
+			// The random number generator may be local to this thread, so any
+			// requested seed must be applied here rather than by the caller.
+			if(hasSeed)
+			{
+				Random::Seed(seed);
+				hasSeed = false;
+			}
 		}
 
 		// Do all the calculations.
@@ -1388,7 +1453,9 @@ void Engine::ThreadEntryPoint()
 
 void Engine::CalculateStep()
 {
+	Tracer::Zone zone("Engine::CalculateStep");
 	FrameTimer loadTimer;
+	profile.BeginStep();
 
 	// If there is a pending zoom update then use it
 	// because the zoom will get updated in the main thread
@@ -1406,7 +1473,12 @@ void Engine::CalculateStep()
 	// Handle the mouse input of the mouse navigation
 	HandleMouseInput(activeCommands);
 	// Now, all the ships must decide what they are doing next.
-	ai.Step(player, activeCommands);
+	profile.Begin(StepProfile::AI_STEP);
+	ai.Step(player, activeCommands, [this](size_t count, const function<void(size_t)> &function)
+	{
+		ForEachSeeded(count, function);
+	});
+	profile.End();
 
 	// Clear the active players commands, they are all processed at this point.
 	activeCommands.Clear();
@@ -1425,8 +1497,12 @@ void Engine::CalculateStep()
 	const Ship *flagship = player.Flagship();
 	bool wasHyperspacing = (flagship && flagship->IsEnteringHyperspace());
 	// Move all the ships.
+	profile.Begin(StepProfile::SHIP_MOVEMENT);
 	for(const shared_ptr<Ship> &it : ships)
 		MoveShip(it);
+	// Once every ship has moved, they can all fire their weapons.
+	FireWeapons();
+	profile.End();
 	// If the flagship just began jumping, play the appropriate sound.
 	if(!wasHyperspacing && flagship && flagship->IsEnteringHyperspace())
 	{
@@ -1465,7 +1541,9 @@ void Engine::CalculateStep()
 
 	// Move the asteroids. This must be done before collision detection. Minables
 	// may create visuals or flotsam.
+	profile.Begin(StepProfile::ASTEROIDS);
 	asteroids.Step(newVisuals, newFlotsam, step);
+	profile.End();
 
 	// Move the flotsam. This must happen after the ships move, because flotsam
 	// checks if any ship has picked it up.
@@ -1474,9 +1552,11 @@ void Engine::CalculateStep()
 	Prune(flotsam);
 
 	// Move the projectiles.
+	profile.Begin(StepProfile::PROJECTILES);
 	for(Projectile &projectile : projectiles)
 		projectile.Move(newVisuals, newProjectiles);
 	Prune(projectiles);
+	profile.End();
 
 	// Step the weather.
 	for(Weather &weather : activeWeather)
@@ -1510,11 +1590,14 @@ void Engine::CalculateStep()
 		--grudgeTime;
 
 	// Populate the collision detection lookup sets.
+	profile.Begin(StepProfile::COLLISION_SETS);
 	FillCollisionSets();
+	profile.End();
 
 	// Perform collision detection.
-	for(Projectile &projectile : projectiles)
-		DoCollisions(projectile);
+	profile.Begin(StepProfile::COLLISIONS);
+	DoCollisions();
+	profile.End();
 	// Now that collision detection is done, clear the cache of ships with anti-
 	// missile systems ready to fire.
 	hasAntiMissile.clear();
@@ -1544,9 +1627,12 @@ void Engine::CalculateStep()
 	radar[calcTickTock].SetCenter(newCenter);
 
 	// Populate the radar.
+	profile.Begin(StepProfile::RADAR);
 	FillRadar();
+	profile.End();
 
 	// Draw the planets.
+	profile.Begin(StepProfile::DRAW_LIST);
 	for(const StellarObject &object : playerSystem->Objects())
 		if(object.HasSprite())
 		{
@@ -1614,6 +1700,8 @@ void Engine::CalculateStep()
 	// Draw the visuals.
 	for(const Visual &visual : visuals)
 		batchDraw[calcTickTock].AddVisual(visual);
+	profile.End();
+	profile.EndStep();
 
 	// Keep track of how much of the CPU time we are using.
 	loadSum += loadTimer.Time();
@@ -1710,10 +1798,72 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 	// Launch fighters.
 	ship->Launch(newShips, newVisuals);
 
-	// Fire weapons. If this returns true the ship has at least one anti-missile
-	// system ready to fire.
-	if(ship->Fire(newProjectiles, newVisuals))
-		hasAntiMissile.push_back(ship.get());
+	// Weapons are fired after all ships have moved.
+	firingShips.push_back(ship.get());
+}
+
+
+
+// Fire the weapons of every ship that moved within the player's system this
+// step. Firing only affects the ship itself, so this can be done in parallel.
+void Engine::FireWeapons()
+{
+	if(salvos.size() < firingShips.size())
+		salvos.resize(firingShips.size());
+
+	ForEachSeeded(firingShips.size(), [this](size_t i)
+	{
+		// If this returns true the ship has at least one anti-missile system
+		// ready to fire.
+		Salvo &salvo = salvos[i];
+		salvo.hasAntiMissile = firingShips[i]->Fire(salvo.projectiles, salvo.visuals);
+	});
+
+	// Add the results in the same order as the ships, no matter which thread
+	// did the firing.
+	for(size_t i = 0; i < firingShips.size(); ++i)
+	{
+		Salvo &salvo = salvos[i];
+		Append(newProjectiles, salvo.projectiles);
+		Append(newVisuals, salvo.visuals);
+		if(salvo.hasAntiMissile)
+			hasAntiMissile.push_back(firingShips[i]);
+	}
+	firingShips.clear();
+}
+
+
+
+// Get the pool to do a batch of work with. If parallel simulation is enabled
+// and the work can be spread across threads, that is all the worker threads.
+// Otherwise, it is only the calling thread.
+WorkerPool &Engine::Workers(bool canSpread)
+{
+	if(!canSpread || !Preferences::Has("Parallel simulation"))
+		return serialWorkers;
+	if(!workers)
+		workers.reset(new WorkerPool());
+	return *workers;
+}
+
+
+
+// Call the given function for every index from 0 to count - 1, spread across
+// the worker threads if parallel simulation is enabled.
+void Engine::ForEach(size_t count, const function<void(size_t)> &function)
+{
+	Workers(true).Run(count, function);
+}
+
+
+
+// As above, but give each call its own random number stream, so that the
+// results are the same no matter how many threads took part. Reseeding only
+// gives each call its own stream if every thread has its own generator, so
+// otherwise the calls are all made by this thread.
+void Engine::ForEachSeeded(size_t count, const function<void(size_t)> &function)
+{
+	Workers(Random::IsThreadLocal()).RunSeeded(count, function);
 }
 
 
@@ -1721,13 +1871,33 @@ void Engine::MoveShip(const shared_ptr<Ship> &ship)
 // Populate the ship collision detection set for projectile & flotsam computations.
 void Engine::FillCollisionSets()
 {
-	shipCollisions.Clear(step);
+	// Ships stay in the collision set from one step to the next, so that only
+	// those that have moved to different grid cells need to be re-sorted.
 	for(const shared_ptr<Ship> &it : ships)
 		if(it->GetSystem() == player.GetSystem() && it->Zoom() == 1.)
-			shipCollisions.Add(*it);
+		{
+			auto inserted = shipCollisionHandles.emplace(it.get(), make_pair(0u, step));
+			if(inserted.second)
+				inserted.first->second.first = shipCollisions.Insert(*it);
+			else
+				inserted.first->second.second = step;
+		}
+
+	// Remove any ships that were not seen this step. They may have been
+	// destroyed, so they must not be accessed.
+	for(auto it = shipCollisionHandles.begin(); it != shipCollisionHandles.end(); )
+	{
+		if(it->second.second != step)
+		{
+			shipCollisions.Remove(it->second.first);
+			it = shipCollisionHandles.erase(it);
+		}
+		else
+			++it;
+	}
 
 	// Get the ship collision set ready to query.
-	shipCollisions.Finish();
+	shipCollisions.Update(step);
 }
 
 
@@ -2091,22 +2261,85 @@ void Engine::HandleMouseInput(Command &activeCommands)
 
 
 
-// Perform collision detection. Note that unlike the preceding functions, this
-// one adds any visuals that are created directly to the main visuals list. If
-// this is multi-threaded in the future, that will need to change.
-void Engine::DoCollisions(Projectile &projectile)
+// Perform collision detection. Finding what each projectile hits may be done
+// on several threads, but applying the hits is not, so unlike the preceding
+// functions, this one adds any visuals that are created directly to the main
+// visuals list.
+void Engine::DoCollisions()
+{
+	// Phasing projectiles check their target's mask directly, and the target may
+	// not be in a collision set that has already brought it up to date.
+	for(const Projectile &projectile : projectiles)
+		if(projectile.GetWeapon().IsPhasing() && projectile.Target())
+			projectile.Target()->GetMask(step);
+
+	// Finding out what each projectile will hit only reads the collision sets,
+	// so it is done in parallel, in chunks that each reuse a buffer for the
+	// results of circle queries.
+	hits.clear();
+	hits.resize(projectiles.size());
+	size_t chunks = (projectiles.size() + COLLISION_CHUNK - 1) / COLLISION_CHUNK;
+	ForEach(chunks, [this](size_t chunk)
+	{
+		vector<Body *> nearby;
+		size_t end = min(projectiles.size(), (chunk + 1) * COLLISION_CHUNK);
+		for(size_t i = chunk * COLLISION_CHUNK; i < end; ++i)
+			FindHit(projectiles[i], hits[i], nearby);
+	});
+
+	// The projectiles that were not set off or stopped by anything above are
+	// checked against the ships all at once, sorted so that projectiles in
+	// the same part of the grid are checked one after another.
+	shipLines.clear();
+	for(size_t i = 0; i < projectiles.size(); ++i)
+	{
+		const Projectile &projectile = projectiles[i];
+		if(hits[i].distance > 0. && projectile.GetGovernment()
+				&& !(projectile.GetWeapon().IsPhasing() && projectile.Target()))
+			shipLines.emplace_back(projectile.Position(), projectile.Position() + projectile.Velocity(),
+				projectile.GetGovernment(), projectile.Target(), i);
+	}
+	shipCollisions.Sort(shipLines);
+	ForEach((shipLines.size() + COLLISION_CHUNK - 1) / COLLISION_CHUNK, [this](size_t chunk)
+	{
+		size_t end = min(shipLines.size(), (chunk + 1) * COLLISION_CHUNK);
+		shipCollisions.Lines(shipLines.data() + chunk * COLLISION_CHUNK, shipLines.data() + end);
+	});
+	for(const CollisionSet::LineQuery &query : shipLines)
+		if(query.hit)
+		{
+			Hit &hit = hits[query.index];
+			Ship *ship = reinterpret_cast<Ship *>(query.hit);
+			hit.distance = query.closestHit;
+			hit.ship = ship->shared_from_this();
+			hit.velocity = ship->Velocity();
+		}
+
+	// An asteroid that is closer than the ship a projectile hit shields it.
+	ForEach(chunks, [this](size_t chunk)
+	{
+		size_t end = min(projectiles.size(), (chunk + 1) * COLLISION_CHUNK);
+		for(size_t i = chunk * COLLISION_CHUNK; i < end; ++i)
+			FindAsteroidHit(projectiles[i], hits[i]);
+	});
+
+	// Damage, events, and anti-missile fire are applied in projectile order.
+	for(size_t i = 0; i < projectiles.size(); ++i)
+		DoCollisions(projectiles[i], hits[i]);
+}
+
+
+
+// Determine whether the given projectile is set off during this step, or hits
+// the only ship it can hit, without changing anything. Collisions with other
+// ships and with asteroids are checked afterwards.
+void Engine::FindHit(const Projectile &projectile, Hit &hit, vector<Body *> &nearby) const
 {
-	// The asteroids can collide with projectiles, the same as any other
-	// object. If the asteroid turns out to be closer than the ship, it
-	// shields the ship (unless the projectile has a blast radius).
-	Point hitVelocity;
-	double closestHit = 1.;
-	shared_ptr<Ship> hit;
 	const Government *gov = projectile.GetGovernment();
 
 	// If this "projectile" is a ship explosion, it always explodes.
 	if(!gov)
-		closestHit = 0.;
+		hit.distance = 0.;
 	else if(projectile.GetWeapon().IsPhasing() && projectile.Target())
 	{
 		// "Phasing" projectiles that have a target will never hit any other ship.
@@ -2117,8 +2350,8 @@ void Engine::DoCollisions(Projectile &projectile)
 			double range = target->GetMask(step).Collide(offset, projectile.Velocity(), target->Facing());
 			if(range < 1.)
 			{
-				closestHit = range;
-				hit = target;
+				hit.distance = range;
+				hit.ship = target;
 			}
 		}
 	}
@@ -2127,44 +2360,58 @@ void Engine::DoCollisions(Projectile &projectile)
 		// For weapons with a trigger radius, check if any detectable object will set it off.
 		double triggerRadius = projectile.GetWeapon().TriggerRadius();
 		if(triggerRadius)
-			for(const Body *body : shipCollisions.Circle(projectile.Position(), triggerRadius))
+		{
+			shipCollisions.Circle(projectile.Position(), triggerRadius, nearby);
+			for(const Body *body : nearby)
 				if(body == projectile.Target() || (gov->IsEnemy(body->GetGovernment())
 						&& reinterpret_cast<const Ship *>(body)->Cloaking() < 1.))
 				{
-					closestHit = 0.;
+					hit.distance = 0.;
 					break;
 				}
-
-		// If nothing triggered the projectile, check for collisions with ships.
-		if(closestHit > 0.)
-		{
-			Ship *ship = reinterpret_cast<Ship *>(shipCollisions.Line(projectile, &closestHit));
-			if(ship)
-			{
-				hit = ship->shared_from_this();
-				hitVelocity = ship->Velocity();
-			}
-		}
-		// "Phasing" projectiles can pass through asteroids. For all other
-		// projectiles, check if they've hit an asteroid that is closer than any
-		// ship that they have hit.
-		if(!projectile.GetWeapon().IsPhasing())
-		{
-			Body *asteroid = asteroids.Collide(projectile, &closestHit);
-			if(asteroid)
-			{
-				hitVelocity = asteroid->Velocity();
-				hit.reset();
-			}
 		}
 	}
+}
+
+
+
+// Check whether the given projectile hits an asteroid that is closer than
+// whatever else it has hit, without changing anything.
+void Engine::FindAsteroidHit(const Projectile &projectile, Hit &hit) const
+{
+	// The asteroids can collide with projectiles, the same as any other
+	// object. If the asteroid turns out to be closer than the ship, it
+	// shields the ship (unless the projectile has a blast radius). "Phasing"
+	// projectiles can pass through asteroids.
+	if(!projectile.GetGovernment() || projectile.GetWeapon().IsPhasing() || !(hit.distance > 0.))
+		return;
+
+	Body *asteroid = asteroids.Collide(projectile, &hit.distance, &hit.minable);
+	if(asteroid)
+	{
+		hit.velocity = asteroid->Velocity();
+		hit.ship.reset();
+	}
+}
+
+
+
+// Apply the effects of whatever the given projectile hit. If it did not hit
+// anything, give the anti-missile systems a chance to shoot it down.
+void Engine::DoCollisions(Projectile &projectile, const Hit &hit)
+{
+	const Government *gov = projectile.GetGovernment();
+	double closestHit = hit.distance;
 
 	// Check if the projectile hit something.
 	if(closestHit < 1.)
 	{
+		if(hit.minable)
+			hit.minable->TakeDamage(projectile);
+
 		// Create the explosion the given distance along the projectile's
 		// motion path for this step.
-		projectile.Explode(visuals, closestHit, hitVelocity);
+		projectile.Explode(visuals, closestHit, hit.velocity);
 
 		const DamageProfile damage(projectile.GetInfo());
 
@@ -2185,21 +2432,21 @@ void Engine::DoCollisions(Projectile &projectile)
 					continue;
 
 				// Only directly targeted ships get provoked by blast weapons.
-				int eventType = ship->TakeDamage(visuals, damage.CalculateDamage(*ship, ship == hit.get()),
+				int eventType = ship->TakeDamage(visuals, damage.CalculateDamage(*ship, ship == hit.ship.get()),
 					targeted ? gov : nullptr);
 				if(eventType)
 					eventQueue.emplace_back(gov, ship->shared_from_this(), eventType);
 			}
 		}
-		else if(hit)
+		else if(hit.ship)
 		{
-			int eventType = hit->TakeDamage(visuals, damage.CalculateDamage(*hit), gov);
+			int eventType = hit.ship->TakeDamage(visuals, damage.CalculateDamage(*hit.ship), gov);
 			if(eventType)
-				eventQueue.emplace_back(gov, hit, eventType);
+				eventQueue.emplace_back(gov, hit.ship, eventType);
 		}
 
-		if(hit)
-			DoGrudge(hit, gov);
+		if(hit.ship)
+			DoGrudge(hit.ship, gov);
 	}
 	else if(projectile.MissileStrength())
 	{
@@ -29,8 +29,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Preferences.h"
 #include "Radar.h"
 #include "Rectangle.h"
+#include "StepProfile.h"
+#include "WorkerPool.h"
 
 #include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <list>
 #include <map>
 #include <memory>
@@ -39,8 +44,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <vector>
 
 class AlertLabel;
+class Body;
 class Flotsam;
 class Government;
+class Minable;
 class NPC;
 class Outfit;
 class PlanetLabel;
@@ -79,6 +86,15 @@ public:
 	void Step(bool isActive);
 	// Begin the next step of calculations.
 	void Go();
+	// Seed the random number generator used by the calculation thread before
+	// its next step, so that a run of the simulation can be reproduced.
+	void Seed(uint64_t seed);
+	// Get the timing of each phase of the most recent steps. This must only
+	// be used while the calculation thread is paused.
+	const StepProfile &Profile() const;
+	// Get the AI, to report how well its caches are working. This must only be
+	// used while the calculation thread is paused.
+	const AI &GetAI() const;
 
 	// Get any special events that happened in this step.
 	// MainPanel::Step will clear this list.
@@ -127,6 +143,25 @@ private:
 		double angle;
 	};
 
+	// The results of one ship firing its weapons.
+	class Salvo {
+	public:
+		std::vector<Projectile> projectiles;
+		std::vector<Visual> visuals;
+		bool hasAntiMissile = false;
+	};
+
+	// What a projectile will hit during this step, if anything.
+	class Hit {
+	public:
+		// How far along its path for this step the projectile hits something.
+		// If it does not hit anything, this is 1.
+		double distance = 1.;
+		Point velocity;
+		std::shared_ptr<Ship> ship;
+		Minable *minable = nullptr;
+	};
+
 
 private:
 	void EnterSystem();
@@ -135,6 +170,11 @@ private:
 	void CalculateStep();
 
 	void MoveShip(const std::shared_ptr<Ship> &ship);
+	void FireWeapons();
+
+	WorkerPool &Workers(bool canSpread);
+	void ForEach(std::size_t count, const std::function<void(std::size_t)> &function);
+	void ForEachSeeded(std::size_t count, const std::function<void(std::size_t)> &function);
 
 	void SpawnFleets();
 	void SpawnPersons();
@@ -146,7 +186,10 @@ private:
 
 	void FillCollisionSets();
 
-	void DoCollisions(Projectile &projectile);
+	void DoCollisions();
+	void FindHit(const Projectile &projectile, Hit &hit, std::vector<Body *> &nearby) const;
+	void FindAsteroidHit(const Projectile &projectile, Hit &hit) const;
+	void DoCollisions(Projectile &projectile, const Hit &hit);
 	void DoWeather(Weather &weather);
 	void DoCollection(Flotsam &flotsam);
 	void DoScanning(const std::shared_ptr<Ship> &ship);
@@ -179,6 +222,20 @@ private:
 
 	// Track which ships currently have anti-missiles ready to fire.
 	std::vector<Ship *> hasAntiMissile;
+	// Ships that may fire their weapons once all ships have moved, and the
+	// results of each one firing. Salvos are kept between steps to reuse them.
+	std::vector<Ship *> firingShips;
+	std::vector<Salvo> salvos;
+	// What each projectile hit in this step, in the same order as the projectiles.
+	std::vector<Hit> hits;
+	// The projectiles that need to be checked for collisions with ships.
+	std::vector<CollisionSet::LineQuery> shipLines;
+
+	// Worker threads for the parts of each step that are done in parallel. They
+	// are only started once parallel simulation is first used. Otherwise, the
+	// same work is done by a pool that has only the calculation thread.
+	std::unique_ptr<WorkerPool> workers;
+	WorkerPool serialWorkers{1};
 
 	AI ai;
 
@@ -190,6 +247,8 @@ private:
 	bool drawTickTock = false;
 	bool hasFinishedCalculating = true;
 	bool terminate = false;
+	bool hasSeed = false;
+	uint64_t seed = 0;
 	bool wasActive = false;
 	bool isMouseHoldEnabled = false;
 	bool isMouseTurningEnabled = false;
@@ -226,6 +285,9 @@ private:
 	int grudgeTime = 0;
 
 	CollisionSet shipCollisions;
+	// The handle of each ship in the ship collision set, and the last step in
+	// which that ship was eligible to be in it.
+	std::map<const Ship *, std::pair<unsigned, int>> shipCollisionHandles;
 
 	int alarmTime = 0;
 	double flash = 0.;
@@ -267,6 +329,10 @@ private:
 	double load = 0.;
 	int loadCount = 0;
 	double loadSum = 0.;
+	// How long each phase of the calculation step takes, and a copy of the
+	// averages taken while the calculation thread is paused, for drawing.
+	StepProfile profile;
+	double phaseTimes[StepProfile::PHASE_COUNT + 1] = {};
 };
 
 
@@ -441,6 +441,22 @@ time_t Files::Timestamp(const string &filePath)
 
 
 
+size_t Files::Size(const string &filePath)
+{
+#if defined _WIN32
+	struct _stat buf;
+	if(_wstat(Utf8::ToUTF16(filePath).c_str(), &buf))
+		return 0;
+#else
+	struct stat buf;
+	if(stat(filePath.c_str(), &buf))
+		return 0;
+#endif
+	return buf.st_size;
+}
+
+
+
 void Files::Copy(const string &from, const string &to)
 {
 #if defined _WIN32
@@ -0,0 +1,142 @@
+/* FiringCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "FiringCache.h"
+
+#include "Angle.h"
+#include "Body.h"
+
+using namespace std;
+
+namespace {
+	// The number of steps an answer may be reused for.
+	const int MAX_AGE = 3;
+	// How far, in pixels, either end of a projectile's path or the edge of the
+	// target may move before an answer is no longer reused.
+	const double TOLERANCE = 2.;
+}
+
+
+
+// Begin a new step. Answers that are too old are no longer used.
+void FiringCache::BeginStep()
+{
+	++step;
+}
+
+
+
+// Check whether the given weapon's projectile, traveling from offset -p
+// relative to the target along the vector v, was recently found to hit or
+// miss it. Return false if there is no usable answer; otherwise, store the
+// answer in "hits."
+bool FiringCache::Find(int hardpoint, const Body &target, const Mask &mask, const Point &p, const Point &v,
+	bool &hits)
+{
+	++lookups;
+	if(static_cast<size_t>(hardpoint) >= solutions.size())
+		return false;
+
+	for(const Solution &solution : solutions[hardpoint])
+		if(solution.target == &target)
+		{
+			if(!IsValid(solution, target, mask, p, v))
+				return false;
+			hits = solution.hits;
+			++this->hits;
+			return true;
+		}
+	return false;
+}
+
+
+
+// Remember whether the given weapon's projectile hits the given target.
+void FiringCache::Store(int hardpoint, const Body &target, const Mask &mask, const Point &p, const Point &v,
+	bool hits)
+{
+	if(static_cast<size_t>(hardpoint) >= solutions.size())
+		solutions.resize(hardpoint + 1);
+
+	// Replace this target's previous solution, or else one that is too old to
+	// be used, so the list only grows as large as the number of nearby targets.
+	vector<Solution> &list = solutions[hardpoint];
+	Solution *slot = nullptr;
+	for(Solution &solution : list)
+	{
+		if(solution.target == &target)
+		{
+			slot = &solution;
+			break;
+		}
+		if(!slot && step - solution.step > MAX_AGE)
+			slot = &solution;
+	}
+	if(!slot)
+	{
+		list.emplace_back();
+		slot = &list.back();
+	}
+
+	slot->target = &target;
+	slot->mask = &mask;
+	slot->start = -p;
+	slot->end = v - p;
+	slot->facing = target.Facing().Unit();
+	slot->step = step;
+	slot->hits = hits;
+}
+
+
+
+uint64_t FiringCache::Lookups() const
+{
+	return lookups;
+}
+
+
+
+uint64_t FiringCache::Hits() const
+{
+	return hits;
+}
+
+
+
+void FiringCache::ResetCounts()
+{
+	lookups = 0;
+	hits = 0;
+}
+
+
+
+// Check whether a stored solution can answer the given query.
+bool FiringCache::IsValid(const Solution &solution, const Body &target, const Mask &mask, const Point &p,
+	const Point &v) const
+{
+	if(step - solution.step > MAX_AGE || solution.mask != &mask)
+		return false;
+
+	const double toleranceSquared = TOLERANCE * TOLERANCE;
+	if(solution.start.DistanceSquared(-p) > toleranceSquared
+			|| solution.end.DistanceSquared(v - p) > toleranceSquared)
+		return false;
+
+	// Turning moves the edge of the target's mask by up to its radius times the
+	// distance between the two facing vectors.
+	double turn = target.Radius() * solution.facing.Distance(target.Facing().Unit());
+	return turn <= TOLERANCE;
+}
@@ -0,0 +1,97 @@
+/* FiringCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef FIRING_CACHE_H_
+#define FIRING_CACHE_H_
+
+#include "Point.h"
+
+#include <cstdint>
+#include <vector>
+
+class Body;
+class Mask;
+
+
+
+// Class for remembering, for one ship, whether each of its weapons would hit
+// each nearby target if fired. Checking a projectile's path against a target's
+// collision mask is the most expensive part of deciding whether to fire, and
+// the answer rarely changes from one step to the next: if neither end of the
+// path has moved by more than a pixel or two relative to the target, and the
+// target has not turned or changed its animation frame, the answer is reused
+// for a few steps. A change in the target's velocity or acceleration moves the
+// far end of the path (which is extrapolated over the projectile's lifetime),
+// so it invalidates the answer.
+//
+// Each ship has its own cache, so the ships can decide whether to fire in
+// parallel. The cache counts how often it was able to answer a query, so the
+// tolerances can be tuned.
+class FiringCache {
+public:
+	// Begin a new step. Answers that are too old are no longer used.
+	void BeginStep();
+
+	// Check whether the given weapon's projectile, traveling from offset -p
+	// relative to the target along the vector v, was recently found to hit or
+	// miss it. Return false if there is no usable answer; otherwise, store the
+	// answer in "hits."
+	bool Find(int hardpoint, const Body &target, const Mask &mask, const Point &p, const Point &v,
+		bool &hits);
+	// Remember whether the given weapon's projectile hits the given target.
+	void Store(int hardpoint, const Body &target, const Mask &mask, const Point &p, const Point &v,
+		bool hits);
+
+	// Get the number of queries and the number of those that were answered
+	// since the counts were last reset.
+	uint64_t Lookups() const;
+	uint64_t Hits() const;
+	void ResetCounts();
+
+
+private:
+	class Solution {
+	public:
+		const Body *target = nullptr;
+		// The target's mask, which differs from step to step if it is animated.
+		const Mask *mask = nullptr;
+		// The start and end of the projectile's path, relative to the target.
+		Point start;
+		Point end;
+		// The direction the target was facing.
+		Point facing;
+		int step = 0;
+		bool hits = false;
+	};
+
+
+private:
+	// Check whether a stored solution can answer the given query.
+	bool IsValid(const Solution &solution, const Body &target, const Mask &mask, const Point &p,
+		const Point &v) const;
+
+
+private:
+	// The solutions for each hardpoint, in no particular order.
+	std::vector<std::vector<Solution>> solutions;
+	int step = 0;
+
+	uint64_t lookups = 0;
+	uint64_t hits = 0;
+};
+
+
+
+#endif
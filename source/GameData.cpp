@@ -25,6 +25,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataFile.h"
 #include "DataNode.h"
 #include "DataWriter.h"
+#include "DistanceTable.h"
 #include "Effect.h"
 #include "Files.h"
 #include "FillShader.h"
@@ -54,6 +55,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Politics.h"
 #include "Random.h"
 #include "RingShader.h"
+#include "RouteCache.h"
 #include "Ship.h"
 #include "Sprite.h"
 #include "SpriteQueue.h"
@@ -132,8 +134,12 @@ namespace {
 
 
 
-future<void> GameData::BeginLoad(bool onlyLoadData, bool debugMode)
+future<void> GameData::BeginLoad(bool onlyLoadData, bool debugMode, bool preventUpload)
 {
+	// Without a window, sprites are read only for their dimensions and masks.
+	if(preventUpload)
+		spriteQueue.PreventUpload();
+
 	// Initialize the list of "source" folders based on any active plugins.
 	LoadSources();
 
@@ -184,6 +190,9 @@ void GameData::FinishLoading()
 	playerGovernment = objects.governments.Get("Escort");
 
 	politics.Reset();
+
+	// All the sprites have been loaded, so their collision masks can be used.
+	maskManager.UpdateMasks();
 }
 
 
@@ -336,6 +345,8 @@ void GameData::Revert()
 
 	politics.Reset();
 	purchases.clear();
+	DistanceTable::Clear();
+	RouteCache::Clear();
 }
 
 
@@ -427,7 +438,8 @@ void GameData::WriteEconomy(DataWriter &out)
 
 
 
-void GameData::StepEconomy()
+// Advance the economy by the given number of days.
+void GameData::StepEconomy(int days)
 {
 	// First, apply any purchases the player made. These are deferred until now
 	// so that prices will not change as you are buying or selling goods.
@@ -439,29 +451,8 @@ void GameData::StepEconomy()
 	}
 	purchases.clear();
 
-	// Then, have each system generate new goods for local use and trade.
-	for(auto &it : objects.systems)
-		it.second.StepEconomy();
-
-	// Finally, send out the trade goods. This has to be done in a separate step
-	// because otherwise whichever systems trade last would already have gotten
-	// supplied by the other systems.
-	for(auto &it : objects.systems)
-	{
-		System &system = it.second;
-		if(!system.Links().empty())
-			for(const Trade::Commodity &commodity : Commodities())
-			{
-				double supply = system.Supply(commodity.name);
-				for(const System *neighbor : system.Links())
-				{
-					double scale = neighbor->Links().size();
-					if(scale)
-						supply += neighbor->Exports(commodity.name) / scale;
-				}
-				system.SetSupply(commodity.name, supply);
-			}
-	}
+	// Then, have each system generate and trade goods for each day.
+	System::StepEconomy(objects.systems, days);
 }
 
 
@@ -478,6 +469,12 @@ void GameData::AddPurchase(const System &system, const string &commodity, int to
 void GameData::Change(const DataNode &node)
 {
 	objects.Change(node);
+	// Travel distances only depend on the systems, and on the hyperspace links
+	// and wormholes between them.
+	const string &key = node.Token(0);
+	if(key == "system" || key == "link" || key == "unlink" || key == "planet" || key == "wormhole")
+		DistanceTable::Clear();
+	RouteCache::Clear();
 }
 
 
@@ -487,6 +484,8 @@ void GameData::Change(const DataNode &node)
 void GameData::UpdateSystems()
 {
 	objects.UpdateSystems();
+	DistanceTable::Clear();
+	RouteCache::Clear();
 }
 
 
@@ -75,7 +75,7 @@ class Wormhole;
 // universe.
 class GameData {
 public:
-	static std::future<void> BeginLoad(bool onlyLoadData, bool debugMode);
+	static std::future<void> BeginLoad(bool onlyLoadData, bool debugMode, bool preventUpload = false);
 	static void FinishLoading();
 	// Check for objects that are referred to but never defined.
 	static void CheckReferences();
@@ -102,7 +102,9 @@ public:
 	// Functions for the dynamic economy.
 	static void ReadEconomy(const DataNode &node);
 	static void WriteEconomy(DataWriter &out);
-	static void StepEconomy();
+	// Advance the economy by the given number of days, e.g. for a jump that
+	// takes more than one day.
+	static void StepEconomy(int days = 1);
 	static void AddPurchase(const System &system, const std::string &commodity, int tons);
 	// Apply the given change to the universe.
 	static void Change(const DataNode &node);
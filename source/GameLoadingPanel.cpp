@@ -22,7 +22,6 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "GameData.h"
 #include "Information.h"
 #include "Interface.h"
-#include "MaskManager.h"
 #include "MenuAnimationPanel.h"
 #include "MenuPanel.h"
 #include "PlayerInfo.h"
@@ -60,9 +59,6 @@ void GameLoadingPanel::Step()
 		// e.g. due to capitalization errors or other typos.
 		SpriteSet::CheckReferences();
 		Audio::CheckReferences();
-		// All sprites with collision masks should also have their 1x scaled versions, so create
-		// any additional scaled masks from the default one.
-		GameData::GetMaskManager().ScaleMasks();
 		// Set the game's initial internal state.
 		GameData::FinishLoading();
 
@@ -0,0 +1,176 @@
+/* InterceptSolver.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "InterceptSolver.h"
+
+#include "Point.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+
+
+// Find the time for a single problem. If the projectile cannot reach the
+// target, this returns NaN.
+double InterceptSolver::Time(const Point &p, const Point &v, double vp)
+{
+	// How many steps will it take this projectile
+	// to intersect the target?
+	// (p.x + v.x*t)^2 + (p.y + v.y*t)^2 = vp^2*t^2
+	// p.x^2 + 2*p.x*v.x*t + v.x^2*t^2
+	//    + p.y^2 + 2*p.y*v.y*t + v.y^2t^2
+	//    - vp^2*t^2 = 0
+	// (v.x^2 + v.y^2 - vp^2) * t^2
+	//    + (2 * (p.x * v.x + p.y * v.y)) * t
+	//    + (p.x^2 + p.y^2) = 0
+	double a = v.Dot(v) - vp * vp;
+	double b = 2. * p.Dot(v);
+	double c = p.Dot(p);
+	double discriminant = b * b - 4 * a * c;
+	if(discriminant < 0.)
+		return numeric_limits<double>::quiet_NaN();
+
+	discriminant = sqrt(discriminant);
+
+	// The solutions are b +- discriminant.
+	// But it's not a solution if it's negative.
+	double r1 = (-b + discriminant) / (2. * a);
+	double r2 = (-b - discriminant) / (2. * a);
+	if(r1 >= 0. && r2 >= 0.)
+		return min(r1, r2);
+	else if(r1 >= 0. || r2 >= 0.)
+		return max(r1, r2);
+
+	return numeric_limits<double>::quiet_NaN();
+}
+
+
+
+// Remove all problems, and make room for the given number of them.
+void InterceptSolver::Clear(size_t count)
+{
+	for(vector<double> *values : {&px, &py, &vx, &vy, &vp})
+	{
+		values->clear();
+		values->reserve(count);
+	}
+	times.clear();
+}
+
+
+
+// Add a problem. Problems are numbered in the order they are added.
+void InterceptSolver::Add(const Point &p, const Point &v, double vp)
+{
+	px.push_back(p.X());
+	py.push_back(p.Y());
+	vx.push_back(v.X());
+	vy.push_back(v.Y());
+	this->vp.push_back(vp);
+}
+
+
+
+// Solve all the problems that have been added.
+void InterceptSolver::Solve()
+{
+	const size_t count = px.size();
+	times.resize(count);
+	size_t i = 0;
+#ifdef __SSE2__
+	// This follows the same steps as Time(), in the same order, so that the
+	// rounding is the same. A negative discriminant has a square root of NaN,
+	// which makes both solutions NaN, so it needs no special handling.
+	const __m128d zero = _mm_setzero_pd();
+	const __m128d two = _mm_set1_pd(2.);
+	const __m128d four = _mm_set1_pd(4.);
+	const __m128d signBit = _mm_set1_pd(-0.);
+	const __m128d notANumber = _mm_set1_pd(numeric_limits<double>::quiet_NaN());
+	for( ; i + 2 <= count; i += 2)
+	{
+		const __m128d x = _mm_loadu_pd(&px[i]);
+		const __m128d y = _mm_loadu_pd(&py[i]);
+		const __m128d dx = _mm_loadu_pd(&vx[i]);
+		const __m128d dy = _mm_loadu_pd(&vy[i]);
+		const __m128d speed = _mm_loadu_pd(&vp[i]);
+
+		const __m128d a = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy)), _mm_mul_pd(speed, speed));
+		const __m128d b = _mm_mul_pd(two, _mm_add_pd(_mm_mul_pd(x, dx), _mm_mul_pd(y, dy)));
+		const __m128d c = _mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y));
+		const __m128d root = _mm_sqrt_pd(_mm_sub_pd(_mm_mul_pd(b, b), _mm_mul_pd(_mm_mul_pd(four, a), c)));
+
+		const __m128d negativeB = _mm_xor_pd(b, signBit);
+		const __m128d twoA = _mm_mul_pd(two, a);
+		const __m128d r1 = _mm_div_pd(_mm_add_pd(negativeB, root), twoA);
+		const __m128d r2 = _mm_div_pd(_mm_sub_pd(negativeB, root), twoA);
+
+		// Use the smaller solution if both are positive, or the positive one
+		// if only one is. These match what min() and max() do with NaN.
+		const __m128d isFirst = _mm_cmpge_pd(r1, zero);
+		const __m128d isSecond = _mm_cmpge_pd(r2, zero);
+		const __m128d isBoth = _mm_and_pd(isFirst, isSecond);
+		const __m128d isEither = _mm_or_pd(isFirst, isSecond);
+		const __m128d either = _mm_or_pd(_mm_and_pd(isEither, _mm_max_pd(r2, r1)), _mm_andnot_pd(isEither, notANumber));
+		const __m128d result = _mm_or_pd(_mm_and_pd(isBoth, _mm_min_pd(r2, r1)), _mm_andnot_pd(isBoth, either));
+		_mm_storeu_pd(&times[i], result);
+	}
+#endif
+	for( ; i < count; ++i)
+		times[i] = Time(Point(px[i], py[i]), Point(vx[i], vy[i]), vp[i]);
+}
+
+
+
+// Get the solution to the given problem, once Solve() has been called.
+double InterceptSolver::Time(size_t index) const
+{
+	return times[index];
+}
+
+
+
+size_t InterceptSolver::Size() const
+{
+	return px.size();
+}
+
+
+
+// Get the values that the given problem was added with.
+Point InterceptSolver::Position(size_t index) const
+{
+	return Point(px[index], py[index]);
+}
+
+
+
+Point InterceptSolver::Velocity(size_t index) const
+{
+	return Point(vx[index], vy[index]);
+}
+
+
+
+double InterceptSolver::Speed(size_t index) const
+{
+	return vp[index];
+}
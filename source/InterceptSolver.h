@@ -0,0 +1,67 @@
+/* InterceptSolver.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef INTERCEPT_SOLVER_H_
+#define INTERCEPT_SOLVER_H_
+
+#include <cstddef>
+#include <vector>
+
+class Point;
+
+
+
+// Class for finding how long it will take projectiles to reach their targets.
+// Each problem is given by the target's position and velocity relative to the
+// point the projectile is fired from, and by the projectile's speed. Problems
+// are collected into separate arrays for each coordinate, so that a whole batch
+// can be solved with the processor's vector instructions, two at a time. The
+// results are exactly the same as solving each problem on its own.
+class InterceptSolver {
+public:
+	// Find the time for a single problem. If the projectile cannot reach the
+	// target, this returns NaN.
+	static double Time(const Point &p, const Point &v, double vp);
+
+
+public:
+	// Remove all problems, and make room for the given number of them.
+	void Clear(std::size_t count = 0);
+	// Add a problem. Problems are numbered in the order they are added.
+	void Add(const Point &p, const Point &v, double vp);
+	// Solve all the problems that have been added.
+	void Solve();
+
+	// Get the solution to the given problem, once Solve() has been called.
+	double Time(std::size_t index) const;
+	std::size_t Size() const;
+	// Get the values that the given problem was added with.
+	Point Position(std::size_t index) const;
+	Point Velocity(std::size_t index) const;
+	double Speed(std::size_t index) const;
+
+
+private:
+	std::vector<double> px;
+	std::vector<double> py;
+	std::vector<double> vx;
+	std::vector<double> vy;
+	std::vector<double> vp;
+	std::vector<double> times;
+};
+
+
+
+#endif
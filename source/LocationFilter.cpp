@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "DataWriter.h"
 #include "DistanceMap.h"
+#include "DistanceTable.h"
 #include "GameData.h"
 #include "Government.h"
 #include "Planet.h"
@@ -73,6 +74,21 @@ namespace {
 	// Check if the given system is within the given distance of the center.
 	int Distance(const System *center, const System *system, int maximum, DistanceCalculationSettings distanceSettings)
 	{
+		// Look the distance up in the table for these travel options, if it is
+		// ready. A distance within the maximum is the same with or without a
+		// limit. A longer route may have a shorter (but more fuel-hungry)
+		// alternative within the limit if there are jumps or wormholes to
+		// choose from, so only ordinary hyperspace routes can be ruled out.
+		int days = -1;
+		if(DistanceTable::Get(distanceSettings)->Find(center, system, days))
+		{
+			if(days >= 0 && days <= maximum)
+				return days;
+			if(days < 0 || (!distanceSettings.AssumesJumpDrive()
+					&& distanceSettings.WormholeStrat() == WormholeStrategy::NONE))
+				return -1;
+		}
+
 		// This function should only ever be called from the main thread, but
 		// just to be sure, use mutex protection on the static locals.
 		static mutex distanceMutex;
@@ -103,8 +119,8 @@ namespace {
 			);
 		}
 		// If the distance is greater than the maximum, this is not a match.
-		int d = distance.Days(system);
-		return (d > maximum) ? -1 : d;
+		days = distance.Days(system);
+		return (days > maximum) ? -1 : days;
 	}
 
 	// Check that at least one neighbor of the hub system matches, for each of the neighbor filters.
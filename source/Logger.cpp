@@ -16,13 +16,38 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Logger.h"
 
 #include <iostream>
+#include <map>
 #include <mutex>
+#include <thread>
 
 using namespace std;
 
 namespace {
 	function<void(const string &message)> logErrorCallback = nullptr;
 	mutex logErrorMutex;
+	// The lists that each thread's errors are being captured in, if any.
+	map<thread::id, vector<string> *> captures;
+}
+
+
+
+Logger::Capture::Capture(vector<string> &messages)
+{
+	lock_guard<mutex> lock(logErrorMutex);
+	vector<string> *&current = captures[this_thread::get_id()];
+	previous = current;
+	current = &messages;
+}
+
+
+
+Logger::Capture::~Capture()
+{
+	lock_guard<mutex> lock(logErrorMutex);
+	if(previous)
+		captures[this_thread::get_id()] = previous;
+	else
+		captures.erase(this_thread::get_id());
 }
 
 
@@ -37,6 +62,15 @@ void Logger::SetLogErrorCallback(function<void(const string &message)> callback)
 void Logger::LogError(const string &message)
 {
 	lock_guard<mutex> lock(logErrorMutex);
+	if(!captures.empty())
+	{
+		auto it = captures.find(this_thread::get_id());
+		if(it != captures.end())
+		{
+			it->second->push_back(message);
+			return;
+		}
+	}
 	// Log by default to stderr.
 	cerr << message << endl;
 	// Perform additional logging through callback if any is registered.
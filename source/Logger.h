@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include <functional>
 #include <string>
+#include <vector>
 
 
 
@@ -25,6 +26,23 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // conventions and requirements on how they handle logging, so the running
 // program should register its preferred logging facility when starting up.
 class Logger {
+public:
+	// While an object of this class exists, errors logged by the thread that
+	// created it are added to the given list instead of being logged, so that
+	// they can be logged together later on.
+	class Capture {
+	public:
+		explicit Capture(std::vector<std::string> &messages);
+		~Capture();
+
+		Capture(const Capture &other) = delete;
+		Capture &operator=(const Capture &other) = delete;
+
+	private:
+		std::vector<std::string> *previous;
+	};
+
+
 public:
 	static void SetLogErrorCallback(std::function<void(const std::string &message)> callback);
 	static void LogError(const std::string &message);
@@ -0,0 +1,93 @@
+/* MappedFile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "MappedFile.h"
+
+#include "File.h"
+#include "Files.h"
+
+#if !defined _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+
+
+MappedFile::MappedFile(const string &path)
+{
+	File file(path);
+	if(!file)
+		return;
+
+#if !defined _WIN32
+	struct stat info;
+	if(!fstat(fileno(file), &info) && S_ISREG(info.st_mode) && info.st_size > 0)
+	{
+		void *address = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fileno(file), 0);
+		if(address != MAP_FAILED)
+		{
+			data = static_cast<const char *>(address);
+			size = info.st_size;
+			isMapped = true;
+			return;
+		}
+	}
+#endif
+
+	// If the file cannot be mapped, fall back to reading all of it.
+	buffer = Files::Read(file);
+	data = buffer.data();
+	size = buffer.size();
+}
+
+
+
+MappedFile::~MappedFile() noexcept
+{
+#if !defined _WIN32
+	if(isMapped)
+		munmap(const_cast<char *>(data), size);
+#endif
+}
+
+
+
+const char *MappedFile::begin() const
+{
+	return data;
+}
+
+
+
+const char *MappedFile::end() const
+{
+	return data + size;
+}
+
+
+
+size_t MappedFile::Size() const
+{
+	return size;
+}
+
+
+
+bool MappedFile::IsEmpty() const
+{
+	return !size;
+}
@@ -0,0 +1,52 @@
+/* MappedFile.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MAPPED_FILE_H_
+#define MAPPED_FILE_H_
+
+#include <cstddef>
+#include <string>
+
+
+
+// RAII wrapper for the read-only contents of a whole file. Where the operating
+// system allows it, the file is mapped into memory instead of being copied, so
+// its contents are only read from the disk as they are used.
+class MappedFile {
+public:
+	explicit MappedFile(const std::string &path);
+	MappedFile(const MappedFile &) = delete;
+	~MappedFile() noexcept;
+
+	MappedFile &operator=(const MappedFile &) = delete;
+
+	// Get the contents of the file. These stay valid until it is destroyed.
+	const char *begin() const;
+	const char *end() const;
+	std::size_t Size() const;
+	bool IsEmpty() const;
+
+
+private:
+	const char *data = nullptr;
+	std::size_t size = 0;
+	bool isMapped = false;
+	// If the file could not be mapped, this is a copy of its contents.
+	std::string buffer;
+};
+
+
+
+#endif
@@ -21,6 +21,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <algorithm>
 #include <cmath>
 #include <limits>
+#include <utility>
 
 using namespace std;
 
@@ -268,6 +269,13 @@ namespace {
 	}
 
 
+	// The most edges in one box of the hierarchy.
+	const unsigned LEAF_EDGES = 8;
+	// How much to enlarge the boxes by when checking whether a segment or a ray
+	// crosses them, so that rounding errors never cause an edge to be skipped.
+	const double BOX_PADDING = 1e-6;
+
+
 	// Find the radius of the object.
 	double ComputeRadius(const vector<Point> &outline)
 	{
@@ -283,15 +291,15 @@ namespace {
 // Construct a mask from the alpha channel of an RGBA-formatted image.
 void Mask::Create(const ImageBuffer &image, int frame)
 {
-	outlines.clear();
-	radius = 0.;
+	*this = Mask();
 
 	vector<vector<Point>> raw;
 	Trace(image, frame, raw);
 	if(raw.empty())
 		return;
 
-	outlines.reserve(raw.size());
+	auto result = make_shared<Data>();
+	auto separate = make_shared<vector<vector<Point>>>();
 	for(auto &edge : raw)
 	{
 		SmoothAndCenter(edge, Point(image.Width(), image.Height()));
@@ -302,10 +310,22 @@ void Mask::Create(const ImageBuffer &image, int frame)
 			continue;
 
 		radius = max(radius, ComputeRadius(outline));
-		outlines.push_back(std::move(outline));
-		outlines.back().shrink_to_fit();
+		result->outlines.push_back(result->points.size());
+		result->points.push_back(outline.back());
+		result->points.insert(result->points.end(), outline.begin(), outline.end());
+		separate->push_back(std::move(outline));
+		++outlineCount;
 	}
-	outlines.shrink_to_fit();
+	if(!outlineCount)
+		return;
+
+	result->outlines.push_back(result->points.size());
+	result->points.shrink_to_fit();
+	result->outlines.shrink_to_fit();
+	BuildTree(*result);
+	result->nodes.shrink_to_fit();
+	data = std::move(result);
+	outlines = std::move(separate);
 }
 
 
@@ -313,7 +333,7 @@ void Mask::Create(const ImageBuffer &image, int frame)
 // Check whether a mask was successfully generated from the image.
 bool Mask::IsLoaded() const
 {
-	return !outlines.empty();
+	return outlineCount;
 }
 
 
@@ -379,13 +399,26 @@ bool Mask::WithinRing(Point point, Angle facing, double inner, double outer) con
 	inner *= inner;
 	outer *= outer;
 
-	for(auto &&outline : outlines)
-		for(auto &&p : outline)
+	// Each point of the outline is the start of one edge. Skip any box that is
+	// entirely inside the inner range or outside the outer range.
+	const Point *points = Points();
+	const Node *nodes = Nodes();
+	for(unsigned i = 0; i < nodeCount; )
+	{
+		const Node &node = nodes[i];
+		if(node.MinDistanceSquared(point) >= outer || node.MaxDistanceSquared(point) <= inner)
+		{
+			i = node.skip;
+			continue;
+		}
+		for(unsigned j = node.first; j < node.first + node.count; ++j)
 		{
-			double pSquared = p.DistanceSquared(point);
+			double pSquared = points[j].DistanceSquared(point);
 			if(pSquared < outer && pSquared > inner)
 				return true;
 		}
+		++i;
+	}
 
 	return false;
 }
@@ -404,9 +437,22 @@ double Mask::Range(Point point, Angle facing) const
 	if(Contains(point))
 		return 0.;
 
-	for(auto &&outline : outlines)
-		for(auto &&p : outline)
-			range = min(range, p.Distance(point));
+	// Each point of the outline is the start of one edge. Skip any box that
+	// cannot contain a point closer than the closest one found so far.
+	const Point *points = Points();
+	const Node *nodes = Nodes();
+	for(unsigned i = 0; i < nodeCount; )
+	{
+		const Node &node = nodes[i];
+		if(node.MinDistanceSquared(point) > range * range)
+		{
+			i = node.skip;
+			continue;
+		}
+		for(unsigned j = node.first; j < node.first + node.count; ++j)
+			range = min(range, points[j].Distance(point));
+		++i;
+	}
 
 	return range;
 }
@@ -423,19 +469,15 @@ double Mask::Radius() const
 // Get the individual outlines that comprise this mask.
 const vector<vector<Point>> &Mask::Outlines() const
 {
-	return outlines;
+	static const vector<vector<Point>> EMPTY;
+	return outlines ? *outlines : EMPTY;
 }
 
 
 
 Mask Mask::operator*(double scale) const
 {
-	Mask newMask = *this;
-	for(auto &outline : newMask.outlines)
-		for(Point &p : outline)
-			p *= scale;
-	newMask.radius *= scale;
-	return newMask;
+	return Combine(vector<Mask>(1, *this), scale).front();
 }
 
 
@@ -447,24 +489,93 @@ Mask operator*(double scale, const Mask &mask)
 
 
 
+// Copy the given masks, scaled by the given amount, into a single buffer that
+// all the copies share. The masks are usually the frames of a sprite.
+vector<Mask> Mask::Combine(const vector<Mask> &masks, double scale)
+{
+	auto result = make_shared<Data>();
+	vector<Mask> combined(masks.size());
+	for(unsigned i = 0; i < masks.size(); ++i)
+	{
+		const Mask &mask = masks[i];
+		Mask &copy = combined[i];
+		if(!mask.IsLoaded())
+			continue;
+
+		copy.radius = mask.radius * scale;
+		copy.firstPoint = result->points.size();
+		copy.firstOutline = result->outlines.size();
+		copy.outlineCount = mask.outlineCount;
+		copy.firstNode = result->nodes.size();
+		copy.nodeCount = mask.nodeCount;
+
+		// The offsets of the outlines and boxes do not change. Scales are always
+		// positive, so the boxes around the scaled points are the scaled boxes.
+		const Point *points = mask.Points();
+		const unsigned *offsets = &mask.data->outlines[mask.firstOutline];
+		for(unsigned j = 0; j < offsets[mask.outlineCount]; ++j)
+			result->points.push_back(points[j] * scale);
+		result->outlines.insert(result->outlines.end(), offsets, offsets + mask.outlineCount + 1);
+		if(scale == 1.)
+			copy.outlines = mask.outlines;
+		else
+		{
+			auto separate = make_shared<vector<vector<Point>>>(*mask.outlines);
+			for(vector<Point> &outline : *separate)
+				for(Point &point : outline)
+					point *= scale;
+			copy.outlines = std::move(separate);
+		}
+		const Node *nodes = mask.Nodes();
+		for(unsigned j = 0; j < mask.nodeCount; ++j)
+		{
+			result->nodes.push_back(nodes[j]);
+			Node &node = result->nodes.back();
+			node.minX *= scale;
+			node.minY *= scale;
+			node.maxX *= scale;
+			node.maxY *= scale;
+		}
+	}
+	result->points.shrink_to_fit();
+	result->outlines.shrink_to_fit();
+	result->nodes.shrink_to_fit();
+
+	for(Mask &copy : combined)
+		if(copy.IsLoaded())
+			copy.data = result;
+	return combined;
+}
+
+
+
 double Mask::Intersection(Point sA, Point vA) const
 {
 	// Keep track of the closest intersection point found.
 	double closest = 1.;
 
-	for(auto &&outline : outlines)
+	// Only the edges in boxes that the segment enters before the closest
+	// intersection found so far need to be checked.
+	const Point *points = Points();
+	const Node *nodes = Nodes();
+	for(unsigned i = 0; i < nodeCount; )
 	{
-		Point prev = outline.back();
-		for(auto &&next : outline)
+		const Node &node = nodes[i];
+		if(!node.IsCrossed(sA, vA, closest))
+		{
+			i = node.skip;
+			continue;
+		}
+		for(unsigned j = node.first; j < node.first + node.count; ++j)
 		{
 			// Check if there is an intersection. (If not, the cross would be 0.) If
 			// there is, handle it only if it is a point where the segment is
 			// entering the polygon rather than exiting it (i.e. cross > 0).
-			Point vB = next - prev;
+			Point vB = points[j + 1] - points[j];
 			double cross = vB.Cross(vA);
 			if(cross > 0.)
 			{
-				Point vS = prev - sA;
+				Point vS = points[j] - sA;
 				double uB = vA.Cross(vS);
 				double uA = vB.Cross(vS);
 				// If the intersection occurs somewhere within this segment of the
@@ -473,9 +584,8 @@ double Mask::Intersection(Point sA, Point vA) const
 				if((uB >= 0.) & (uB < cross) & (uA >= 0.))
 					closest = min(closest, uA / cross);
 			}
-
-			prev = next;
 		}
+		++i;
 	}
 	return closest;
 }
@@ -496,12 +606,23 @@ bool Mask::Contains(Point point) const
 	// intersects only if its x coordinates span the point's coordinates.
 	// Compute the number of intersections across all outlines, not just one, as the
 	// outlines may be nested (i.e. holes) or discontinuous (multiple separate shapes).
+	// Only boxes that span the point's x coordinate and extend below it can
+	// contain edges that the ray crosses.
 	int intersections = 0;
-	for(auto &&outline : outlines)
+	const Point *points = Points();
+	const Node *nodes = Nodes();
+	for(unsigned i = 0; i < nodeCount; )
 	{
-		Point prev = outline.back();
-		for(auto &&next : outline)
+		const Node &node = nodes[i];
+		if(point.X() < node.minX || point.X() > node.maxX || point.Y() > node.maxY + BOX_PADDING)
+		{
+			i = node.skip;
+			continue;
+		}
+		for(unsigned j = node.first; j < node.first + node.count; ++j)
 		{
+			const Point &prev = points[j];
+			const Point &next = points[j + 1];
 			if(prev.X() != next.X())
 				if((prev.X() <= point.X()) == (point.X() < next.X()))
 				{
@@ -509,9 +630,156 @@ bool Mask::Contains(Point point) const
 						(point.X() - prev.X()) / (next.X() - prev.X());
 					intersections += (y >= point.Y());
 				}
-			prev = next;
 		}
+		++i;
 	}
 	// If the number of intersections is odd, the point is within the mask.
 	return (intersections & 1);
 }
+
+
+
+// Build the hierarchy of boxes for the outlines of this mask, which must be
+// the last mask in the given data. Consecutive edges of an outline are close
+// to each other, so splitting each outline's edges in half at each level gives
+// boxes that are small and do not overlap much.
+void Mask::BuildTree(Data &storage)
+{
+	firstNode = storage.nodes.size();
+	BuildOutlines(storage, 0, outlineCount);
+	nodeCount = storage.nodes.size() - firstNode;
+}
+
+
+
+// Add a node for the given run of edges, and then the nodes below it. The
+// edges must all belong to the same outline.
+void Mask::BuildNode(Data &storage, unsigned first, unsigned count)
+{
+	const Point *points = &storage.points[firstPoint];
+	unsigned index = storage.nodes.size();
+	storage.nodes.emplace_back();
+	Node &node = storage.nodes.back();
+	node.minX = node.maxX = points[first].X();
+	node.minY = node.maxY = points[first].Y();
+	for(unsigned i = first + 1; i <= first + count; ++i)
+	{
+		node.minX = min(node.minX, points[i].X());
+		node.minY = min(node.minY, points[i].Y());
+		node.maxX = max(node.maxX, points[i].X());
+		node.maxY = max(node.maxY, points[i].Y());
+	}
+
+	if(count <= LEAF_EDGES)
+	{
+		node.first = first;
+		node.count = count;
+	}
+	else
+	{
+		node.first = 0;
+		node.count = 0;
+		BuildNode(storage, first, count / 2);
+		BuildNode(storage, first + count / 2, count - count / 2);
+	}
+	storage.nodes[index].skip = storage.nodes.size() - firstNode;
+}
+
+
+
+// Add a node for the given outlines of this mask, and then the nodes below it.
+void Mask::BuildOutlines(Data &storage, unsigned first, unsigned count)
+{
+	if(count == 1)
+	{
+		const unsigned *offsets = &storage.outlines[firstOutline + first];
+		BuildNode(storage, offsets[0], offsets[1] - offsets[0] - 1);
+		return;
+	}
+
+	unsigned index = storage.nodes.size();
+	storage.nodes.emplace_back();
+	BuildOutlines(storage, first, count / 2);
+	unsigned second = storage.nodes.size();
+	BuildOutlines(storage, first + count / 2, count - count / 2);
+
+	// This node's box is the box around both of its children.
+	Node &node = storage.nodes[index];
+	const Node &left = storage.nodes[index + 1];
+	const Node &right = storage.nodes[second];
+	node.minX = min(left.minX, right.minX);
+	node.minY = min(left.minY, right.minY);
+	node.maxX = max(left.maxX, right.maxX);
+	node.maxY = max(left.maxY, right.maxY);
+	node.first = 0;
+	node.count = 0;
+	node.skip = storage.nodes.size() - firstNode;
+}
+
+
+
+// Get the points and boxes of this mask.
+const Point *Mask::Points() const
+{
+	return data->points.data() + firstPoint;
+}
+
+
+
+const Mask::Node *Mask::Nodes() const
+{
+	return data->nodes.data() + firstNode;
+}
+
+
+
+// Get the squared distance from the given point to the nearest point of this box.
+double Mask::Node::MinDistanceSquared(const Point &point) const
+{
+	double dx = max(0., max(minX - point.X(), point.X() - maxX));
+	double dy = max(0., max(minY - point.Y(), point.Y() - maxY));
+	return dx * dx + dy * dy;
+}
+
+
+
+// Get the squared distance from the given point to the farthest point of this box.
+double Mask::Node::MaxDistanceSquared(const Point &point) const
+{
+	double dx = max(fabs(point.X() - minX), fabs(point.X() - maxX));
+	double dy = max(fabs(point.Y() - minY), fabs(point.Y() - maxY));
+	return dx * dx + dy * dy;
+}
+
+
+
+// Check whether the given segment enters this box no farther along it than the
+// given fraction of its length. The box is padded slightly, so that rounding
+// errors never cause an edge to be skipped.
+bool Mask::Node::IsCrossed(const Point &sA, const Point &vA, double limit) const
+{
+	double enter = 0.;
+	double exit = limit;
+	const double start[2] = {sA.X(), sA.Y()};
+	const double direction[2] = {vA.X(), vA.Y()};
+	const double low[2] = {minX - BOX_PADDING, minY - BOX_PADDING};
+	const double high[2] = {maxX + BOX_PADDING, maxY + BOX_PADDING};
+	for(int axis = 0; axis < 2; ++axis)
+	{
+		if(!direction[axis])
+		{
+			if(start[axis] < low[axis] || start[axis] > high[axis])
+				return false;
+			continue;
+		}
+		double t0 = (low[axis] - start[axis]) / direction[axis];
+		double t1 = (high[axis] - start[axis]) / direction[axis];
+		if(t0 > t1)
+			swap(t0, t1);
+		enter = max(enter, t0);
+		exit = min(exit, t1);
+		if(enter > exit)
+			return false;
+	}
+	return true;
+}
@@ -19,6 +19,8 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Angle.h"
 #include "Point.h"
 
+#include <cstddef>
+#include <memory>
 #include <vector>
 
 class ImageBuffer;
@@ -29,7 +31,12 @@ class ImageBuffer;
 // line segment intersects that object or if a point is within a certain distance.
 // The outline is represented in polygonal form, which allows intersection tests
 // to be done much more efficiently than if we were testing individual pixels in
-// the image itself.
+// the image itself. The edges of the outline are also grouped into a hierarchy
+// of bounding boxes, so that each test only needs to examine the few edges that
+// are near the segment or point in question.
+//
+// The points and boxes of a mask are kept in flat arrays, which may be shared
+// with the other frames of the same sprite, so copying a mask is cheap.
 class Mask {
 public:
 	// Construct a mask from the alpha channel of an RGBA-formatted image.
@@ -65,15 +72,79 @@ public:
 	Mask operator*(double scale) const;
 	friend Mask operator*(double scale, const Mask &mask);
 
+	// Copy the given masks, scaled by the given amount, into a single buffer
+	// that all the copies share. The masks are usually the frames of a sprite.
+	static std::vector<Mask> Combine(const std::vector<Mask> &masks, double scale = 1.);
+
+
+private:
+	// A box around a run of consecutive edges. The nodes of the hierarchy are
+	// stored in depth-first order, so that the first child of a node is the
+	// node right after it, and "skip" is the index of the first node that is
+	// not one of its descendants.
+	class Node {
+	public:
+		// The squared distances from the given point to the nearest and the
+		// farthest point of this box.
+		double MinDistanceSquared(const Point &point) const;
+		double MaxDistanceSquared(const Point &point) const;
+		// Check whether the given segment enters this box no farther along it
+		// than the given fraction of its length.
+		bool IsCrossed(const Point &sA, const Point &vA, double limit) const;
+
+		double minX;
+		double minY;
+		double maxX;
+		double maxY;
+		// The edges in this box, if it is a leaf. Other nodes have no edges.
+		// Edge i runs from point i to point i + 1 of the mask.
+		unsigned first;
+		unsigned count;
+		unsigned skip;
+	};
+
+
+private:
+	// The points and boxes of one or more masks. Each outline begins with a
+	// copy of its last point, so that every edge of an outline is a pair of
+	// consecutive points. The index of the first point of each outline, and of
+	// the point after the last outline of each mask, are stored in "outlines."
+	class Data {
+	public:
+		std::vector<Point> points;
+		std::vector<unsigned> outlines;
+		std::vector<Node> nodes;
+	};
+
 
 private:
 	double Intersection(Point sA, Point vA) const;
 	bool Contains(Point point) const;
 
+	// Build the hierarchy of boxes for the outlines of this mask, which must
+	// be the last mask in the given storage.
+	void BuildTree(Data &storage);
+	void BuildNode(Data &storage, unsigned first, unsigned count);
+	void BuildOutlines(Data &storage, unsigned first, unsigned count);
+	// Get the points and boxes of this mask.
+	const Point *Points() const;
+	const Node *Nodes() const;
+
 
 private:
-	std::vector<std::vector<Point>> outlines;
+	std::shared_ptr<const Data> data;
+	// The same outlines as separate lists of points, for anything that needs to
+	// walk along them. They are made along with the rest of the mask.
+	std::shared_ptr<const std::vector<std::vector<Point>>> outlines;
 	double radius = 0.;
+
+	// Where this mask's points, outlines, and boxes begin in the data. The
+	// indices stored in the outlines and boxes are relative to these.
+	unsigned firstPoint = 0;
+	unsigned firstOutline = 0;
+	unsigned outlineCount = 0;
+	unsigned firstNode = 0;
+	unsigned nodeCount = 0;
 };
 
 
@@ -32,61 +32,51 @@ namespace {
 
 
 
-// Move the given masks at 1x scale into the manager's storage.
+// Move the given masks at 1x scale into the manager's storage. They are not
+// used until the next time the masks are updated, so that masks that may be in
+// use by another thread are never replaced.
 void MaskManager::SetMasks(const Sprite *sprite, vector<Mask> &&masks)
 {
+	// Store all the frames in one buffer, which their scaled versions will
+	// also be created from.
+	vector<Mask> combined = Mask::Combine(masks);
+	masks.clear();
+
 	lock_guard<mutex> lock(spriteMutex);
-	auto &scales = spriteMasks[sprite];
-	auto it = scales.find(DEFAULT);
-	if(it != scales.end())
-		it->second.swap(masks);
-	else
-		scales.emplace(DEFAULT, std::move(masks));
+	pendingMasks[sprite].swap(combined);
 }
 
 
 
-// Add a scale that the given sprite needs to have a mask for.
-void MaskManager::RegisterScale(const Sprite *sprite, double scale)
+// Start using the masks that have been given since this was last done. This
+// must not be done while any other thread may be requesting masks, e.g. while
+// the engine is calculating a step.
+void MaskManager::UpdateMasks()
 {
 	lock_guard<mutex> lock(spriteMutex);
-	auto &scales = spriteMasks[sprite];
-	auto lb = scales.lower_bound(scale);
-	if(lb == scales.end() || lb->first != scale)
-		scales.emplace_hint(lb, scale, vector<Mask>{});
-	else if(!lb->second.empty())
-		Logger::LogError("Collision mask for sprite \"" + sprite->Name() + "\" at scale "
-			+ PrintScale(scale) + " was already generated.");
+	for(auto &pit : pendingMasks)
+	{
+		auto &scales = spriteMasks[pit.first];
+		for(auto &it : scales)
+		{
+			it.second.masks.clear();
+			it.second.isReady = false;
+		}
+		ScaledMasks &base = scales[DEFAULT];
+		base.masks.swap(pit.second);
+		base.isReady = true;
+	}
+	pendingMasks.clear();
 }
 
 
 
-// Create the scaled versions of all masks from the 1x versions.
-void MaskManager::ScaleMasks()
+// Add a scale that the given sprite needs to have a mask for. This must be
+// done before any masks are requested, because requests are not locked.
+void MaskManager::RegisterScale(const Sprite *sprite, double scale)
 {
-	for(auto &spriteScales : spriteMasks)
-	{
-		auto &scales = spriteScales.second;
-		auto baseIt = scales.find(DEFAULT);
-		if(baseIt == scales.end() || baseIt->second.empty())
-			continue;
-
-		const auto &baseMasks = baseIt->second;
-		for(auto it = scales.begin(); it != baseIt; ++it)
-		{
-			auto &masks = it->second;
-			masks.reserve(baseMasks.size());
-			for(auto &&mask : baseMasks)
-				masks.push_back(mask * it->first);
-		}
-		for(auto it = next(baseIt); it != scales.end(); ++it)
-		{
-			auto &masks = it->second;
-			masks.reserve(baseMasks.size());
-			for(auto &&mask : baseMasks)
-				masks.push_back(mask * it->first);
-		}
-	}
+	lock_guard<mutex> lock(spriteMutex);
+	spriteMasks[sprite][scale];
 }
 
 
@@ -99,17 +89,37 @@ const std::vector<Mask> &MaskManager::GetMasks(const Sprite *sprite, double scal
 	const auto scalesIt = spriteMasks.find(sprite);
 	if(scalesIt == spriteMasks.end())
 	{
+		lock_guard<mutex> lock(spriteMutex);
 		if(warned.insert(make_pair(sprite, true)).second)
 			Logger::LogError("Warning: sprite \"" + sprite->Name() + "\": no collision masks found.");
 		return EMPTY;
 	}
 
+	// The set of sprites and scales does not change once masks are being
+	// requested, so it can be searched without a lock, but the masks for a
+	// scale other than 1x are created by whichever thread first needs them.
 	const auto &scales = scalesIt->second;
 	const auto maskIt = scales.find(scale);
-	if(maskIt != scales.end() && !maskIt->second.empty())
-		return maskIt->second;
+	if(maskIt != scales.end())
+	{
+		const ScaledMasks &scaled = maskIt->second;
+		if(!scaled.isReady.load(memory_order_acquire))
+		{
+			lock_guard<mutex> lock(spriteMutex);
+			if(!scaled.isReady.load(memory_order_relaxed))
+			{
+				const auto baseIt = scales.find(DEFAULT);
+				if(baseIt != scales.end() && baseIt->second.isReady.load(memory_order_relaxed))
+					scaled.masks = Mask::Combine(baseIt->second.masks, scale);
+				scaled.isReady.store(true, memory_order_release);
+			}
+		}
+		if(!scaled.masks.empty())
+			return scaled.masks;
+	}
 
 	// Shouldn't happen, but just in case, print some details about the scales for this sprite (once).
+	lock_guard<mutex> lock(spriteMutex);
 	if(warned.insert(make_pair(sprite, true)).second)
 	{
 		string warning = "Warning: sprite \"" + sprite->Name() + "\": collision mask not found.";
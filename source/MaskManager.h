@@ -18,6 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "Mask.h"
 
+#include <atomic>
 #include <map>
 #include <mutex>
 #include <vector>
@@ -28,28 +29,44 @@ class Sprite;
 
 
 // Class that stores the masks for sprites that have them, and provides the correct
-// mask for the scale that the sprite requests.
+// mask for the scale that the sprite requests. The masks for each scale other
+// than 1x are created from the 1x versions the first time they are requested.
 class MaskManager {
 public:
-	// Move the given masks at 1x scale into the manager's storage.
+	// Move the given masks at 1x scale into the manager's storage. They are not
+	// used until the next time the masks are updated, so that masks that may
+	// be in use by another thread are never replaced.
 	void SetMasks(const Sprite *sprite, std::vector<Mask> &&masks);
+	// Start using the masks that have been given since this was last done. This
+	// must not be done while any other thread may be requesting masks, e.g.
+	// while the engine is calculating a step.
+	void UpdateMasks();
 
-	// Add a scale that the given sprite needs to have a mask for.
+	// Add a scale that the given sprite needs to have a mask for. This must be
+	// done before any masks are requested, because requests are not locked.
 	void RegisterScale(const Sprite *sprite, double scale);
 
-	// Create the scaled versions of all masks from the 1x versions.
-	void ScaleMasks();
-
 	// Get the masks for the given sprite at the given scale. If a
 	// sprite has no masks, an empty mask is returned.
 	const std::vector<Mask> &GetMasks(const Sprite *sprite, double scale) const;
 
 
 private:
-	std::map<const Sprite *, std::map<double, std::vector<Mask>>> spriteMasks;
+	// The masks of a sprite at one scale, which may not have been created yet.
+	class ScaledMasks {
+	public:
+		mutable std::vector<Mask> masks;
+		mutable std::atomic<bool> isReady{false};
+	};
+
+
+private:
+	std::map<const Sprite *, std::map<double, ScaledMasks>> spriteMasks;
+	// Masks at 1x scale that have been given but are not in use yet.
+	std::map<const Sprite *, std::vector<Mask>> pendingMasks;
 
 	// Mutex to make sure different threads don't modify the masks at the same time.
-	std::mutex spriteMutex;
+	mutable std::mutex spriteMutex;
 };
 
 
@@ -18,7 +18,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "DataNode.h"
 #include "DataWriter.h"
 #include "Dialog.h"
-#include "DistanceMap.h"
+#include "DistanceTable.h"
 #include "text/Format.h"
 #include "GameData.h"
 #include "Government.h"
@@ -35,6 +35,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <cmath>
 #include <limits>
 #include <sstream>
+#include <vector>
 
 using namespace std;
 
@@ -1479,7 +1480,7 @@ int Mission::CalculateJumps(const System *sourceSystem)
 	// Estimate how far the player will have to travel to visit all the waypoints
 	// and stopovers and then to land on the destination planet. Rather than a
 	// full traveling salesman path, just calculate a greedy approximation.
-	list<const System *> destinations;
+	vector<const System *> destinations;
 	for(const System *system : waypoints)
 		destinations.push_back(system);
 	for(const Planet *planet : stopovers)
@@ -1488,34 +1489,25 @@ int Mission::CalculateJumps(const System *sourceSystem)
 	while(!destinations.empty())
 	{
 		// Find the closest destination to this location.
-		DistanceMap distance(sourceSystem,
-				distanceCalcSettings.WormholeStrat(),
-				distanceCalcSettings.AssumesJumpDrive());
-		auto it = destinations.begin();
-		auto bestIt = it;
-		int bestDays = distance.Days(*bestIt);
+		const vector<int> days = DistanceTable::Days(sourceSystem, destinations, distanceCalcSettings);
+		size_t best = 0;
+		int bestDays = days[best];
 		if(bestDays < 0)
 			bestDays = numeric_limits<int>::max();
-		for(++it; it != destinations.end(); ++it)
-		{
-			int days = distance.Days(*it);
-			if(days >= 0 && days < bestDays)
+		for(size_t i = 1; i < days.size(); ++i)
+			if(days[i] >= 0 && days[i] < bestDays)
 			{
-				bestIt = it;
-				bestDays = days;
+				best = i;
+				bestDays = days[i];
 			}
-		}
 
-		sourceSystem = *bestIt;
+		sourceSystem = destinations[best];
 		// If currently unreachable, this system adds -1 to the deadline, to match previous behavior.
 		expectedJumps += bestDays == numeric_limits<int>::max() ? -1 : bestDays;
-		destinations.erase(bestIt);
+		destinations.erase(destinations.begin() + best);
 	}
-	DistanceMap distance(sourceSystem,
-			distanceCalcSettings.WormholeStrat(),
-			distanceCalcSettings.AssumesJumpDrive());
 	// If currently unreachable, this system adds -1 to the deadline, to match previous behavior.
-	expectedJumps += distance.Days(destination->GetSystem());
+	expectedJumps += DistanceTable::Days(sourceSystem, destination->GetSystem(), distanceCalcSettings);
 
 	return expectedJumps;
 }
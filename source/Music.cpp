@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Music.h"
 
 #include "Files.h"
+#include "Tracer.h"
 
 #include <mad.h>
 
@@ -160,6 +161,7 @@ const vector<int16_t> &Music::NextChunk()
 // Entry point for the decoding thread.
 void Music::Decode()
 {
+	Tracer::SetThreadName("music decoder");
 	// This vector will store the input from the file.
 	vector<unsigned char> input(INPUT_CHUNK, 0);
 	// Objects for MP3 decoding:
@@ -207,6 +209,7 @@ void Music::Decode()
 
 			// The lock can be freed until we start filling the output buffer.
 			lock.unlock();
+			Tracer::Zone zone("Music::Decode");
 
 			// See if any input data is left undecoded in the stream. Typically
 			// this is because the last block of input contained a fraction of a
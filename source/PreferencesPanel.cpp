@@ -530,6 +530,8 @@ void PreferencesPanel::DrawSettings()
 		"",
 		"Performance",
 		"Show CPU / GPU load",
+		"Show step timing",
+		"Parallel simulation",
 		"Render motion blur",
 		"Reduce large graphics",
 		"Draw background haze",
@@ -49,6 +49,25 @@ void Random::Seed(uint64_t seed)
 	lock_guard<mutex> lock(workaroundMutex);
 #endif
 	gen.seed(seed);
+	// The distributions may hold on to values they generated earlier (the
+	// normal distribution makes its numbers in pairs), and those must not be
+	// carried over into the new sequence.
+	uniform.reset();
+	real.reset();
+	normal.reset();
+}
+
+
+
+// Check whether each thread has its own generator, in which case seeding
+// it has no effect on the numbers generated in any other thread.
+bool Random::IsThreadLocal()
+{
+#ifndef __linux__
+	return false;
+#else
+	return true;
+#endif
 }
 
 
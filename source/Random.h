@@ -28,6 +28,9 @@ public:
 	// Seed the generator (e.g. to make it produce exactly the same random
 	// numbers it produced previously).
 	static void Seed(uint64_t seed);
+	// Check whether each thread has its own generator, in which case seeding
+	// it has no effect on the numbers generated in any other thread.
+	static bool IsThreadLocal();
 
 	static uint32_t Int();
 	static uint32_t Int(uint32_t modulus);
@@ -0,0 +1,126 @@
+/* RouteCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "RouteCache.h"
+
+#include "DistanceMap.h"
+#include "GameData.h"
+#include "Planet.h"
+#include "Ship.h"
+#include "ShipJumpNavigation.h"
+
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// Everything that a ship's route depends on.
+	class Key {
+	public:
+		bool operator<(const Key &other) const
+		{
+			return tie(source, destination, hyperspaceFuel, jumpFuel, jumpRange, wormholeAccess)
+				< tie(other.source, other.destination, other.hyperspaceFuel, other.jumpFuel, other.jumpRange,
+					other.wormholeAccess);
+		}
+
+		const System *source = nullptr;
+		const System *destination = nullptr;
+		int hyperspaceFuel = 0;
+		int jumpFuel = 0;
+		double jumpRange = 0.;
+		// Whether the ship may use each of the restricted wormholes.
+		vector<bool> wormholeAccess;
+	};
+
+	// Routes are kept in two generations. Once the current one is full, it
+	// replaces the previous one, and any route in the previous one that is
+	// used again moves to the current one. This keeps the routes that are in
+	// use without letting the cache grow without limit.
+	const size_t GENERATION_SIZE = 512;
+
+	mutex cacheMutex;
+	map<Key, shared_ptr<const DistanceMap>> current;
+	map<Key, shared_ptr<const DistanceMap>> previous;
+	// The wormholes that only some ships may use, found when first needed.
+	vector<const Planet *> restrictedWormholes;
+	bool hasWormholeList = false;
+}
+
+
+
+// Get the route for the given ship to the given system, as calculated by
+// DistanceMap(ship, destination).
+shared_ptr<const DistanceMap> RouteCache::Get(const Ship &ship, const System *destination)
+{
+	lock_guard<mutex> lock(cacheMutex);
+
+	if(!hasWormholeList)
+	{
+		for(const auto &it : GameData::Planets())
+			if(it.second.IsWormhole() && !it.second.IsUnrestricted())
+				restrictedWormholes.push_back(&it.second);
+		hasWormholeList = true;
+	}
+
+	const ShipJumpNavigation &navigation = ship.JumpNavigation();
+	Key key;
+	key.source = ship.GetSystem();
+	key.destination = destination;
+	key.hyperspaceFuel = navigation.HyperdriveFuel();
+	key.jumpFuel = navigation.JumpDriveFuel();
+	key.jumpRange = navigation.JumpRange();
+	key.wormholeAccess.reserve(restrictedWormholes.size());
+	for(const Planet *wormhole : restrictedWormholes)
+		key.wormholeAccess.push_back(wormhole->IsAccessible(&ship));
+
+	auto it = current.find(key);
+	if(it != current.end())
+		return it->second;
+
+	shared_ptr<const DistanceMap> route;
+	it = previous.find(key);
+	if(it != previous.end())
+	{
+		route = it->second;
+		previous.erase(it);
+	}
+	else
+		route = make_shared<DistanceMap>(ship, destination);
+
+	if(current.size() >= GENERATION_SIZE)
+	{
+		previous.swap(current);
+		current.clear();
+	}
+	current.emplace(std::move(key), route);
+	return route;
+}
+
+
+
+// Forget all routes. This must be done whenever systems, links, planets,
+// wormholes, or fleets may have changed.
+void RouteCache::Clear()
+{
+	lock_guard<mutex> lock(cacheMutex);
+	current.clear();
+	previous.clear();
+	restrictedWormholes.clear();
+	hasWormholeList = false;
+}
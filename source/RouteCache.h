@@ -0,0 +1,51 @@
+/* RouteCache.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ROUTE_CACHE_H_
+#define ROUTE_CACHE_H_
+
+#include <memory>
+
+class DistanceMap;
+class Ship;
+class System;
+
+
+
+// Class for sharing the routes that AI ships plan between systems. Finding a
+// route is expensive, and many ships with the same travel capabilities travel
+// between the same systems, so each route is only found once and then reused
+// by every ship whose route would be the same: one that starts in the same
+// system, uses the same fuel for each kind of jump, has the same jump range,
+// and may use the same wormholes.
+//
+// The routes depend on the systems and their links, so the cache must be
+// cleared whenever those change. Routes prefer the less dangerous of two
+// otherwise equal paths, and that danger depends on which governments are the
+// player's enemies; routes found before the player's reputation changed may
+// keep using the old tie-break until the cache is next cleared.
+class RouteCache {
+public:
+	// Get the route for the given ship to the given system, as calculated by
+	// DistanceMap(ship, destination).
+	static std::shared_ptr<const DistanceMap> Get(const Ship &ship, const System *destination);
+	// Forget all routes. This must be done whenever systems, links, planets,
+	// wormholes, or fleets may have changed.
+	static void Clear();
+};
+
+
+
+#endif
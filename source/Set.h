@@ -16,8 +16,13 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #ifndef SET_H_
 #define SET_H_
 
+#include <cstddef>
+#include <functional>
 #include <map>
 #include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 
 
 
@@ -27,19 +32,26 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 template<class Type>
 class Set {
 public:
+	Set() = default;
+	// Copying a set requires building a new index for the copied objects.
+	Set(const Set &other);
+	Set &operator=(const Set &other);
+	Set(Set &&) = default;
+	Set &operator=(Set &&) = default;
+
 	// Allow non-const access to the owner of this set; it can hand off only
 	// const references to avoid anyone else modifying the objects.
-	Type *Get(const std::string &name) { return &data[name]; }
-	const Type *Get(const std::string &name) const { return &data[name]; }
+	Type *Get(const std::string &name) { return &Insert(name)->second; }
+	const Type *Get(const std::string &name) const { return &Insert(name)->second; }
 	// If an item already exists in this set, get it. Otherwise, return a null
 	// pointer rather than creating the item.
 	const Type *Find(const std::string &name) const;
 
-	bool Has(const std::string &name) const { return data.count(name); }
+	bool Has(const std::string &name) const { return index.count(&name); }
 
 	typename std::map<std::string, Type>::iterator begin() { return data.begin(); }
 	typename std::map<std::string, Type>::const_iterator begin() const { return data.begin(); }
-	typename std::map<std::string, Type>::const_iterator find(const std::string &key) const { return data.find(key); }
+	typename std::map<std::string, Type>::const_iterator find(const std::string &key) const;
 	typename std::map<std::string, Type>::iterator end() { return data.end(); }
 	typename std::map<std::string, Type>::const_iterator end() const { return data.end(); }
 
@@ -51,16 +63,72 @@ public:
 
 
 private:
+	// The index is keyed by pointers to the names stored in the map, but it
+	// hashes and compares the names themselves. A name to look up can be given
+	// as a pointer to any string.
+	class NameHash {
+	public:
+		size_t operator()(const std::string *name) const { return std::hash<std::string>()(*name); }
+	};
+	class NameEqual {
+	public:
+		bool operator()(const std::string *a, const std::string *b) const { return *a == *b; }
+	};
+
+
+private:
+	// Get the object with the given name, creating it if it does not exist.
+	typename std::map<std::string, Type>::iterator Insert(const std::string &name) const;
+	// Add every object to the index.
+	void Reindex();
+
+
+private:
+	// The objects are kept in order of their names, because much of the game
+	// (and the saved games) relies on iterating over them in that order.
 	mutable std::map<std::string, Type> data;
+	// Finding an object by name goes through this hash table instead of the
+	// map. Map entries never move, so each name is stored only once, in the
+	// map, and the index refers to it.
+	mutable std::unordered_map<const std::string *, typename std::map<std::string, Type>::iterator,
+		NameHash, NameEqual> index;
 };
 
 
 
+template <class Type>
+Set<Type>::Set(const Set &other)
+	: data(other.data)
+{
+	Reindex();
+}
+
+
+
+template <class Type>
+Set<Type> &Set<Type>::operator=(const Set &other)
+{
+	data = other.data;
+	Reindex();
+	return *this;
+}
+
+
+
 template <class Type>
 const Type *Set<Type>::Find(const std::string &name) const
 {
-	auto it = data.find(name);
-	return (it == data.end() ? nullptr : &it->second);
+	auto it = index.find(&name);
+	return (it == index.end() ? nullptr : &it->second->second);
+}
+
+
+
+template <class Type>
+typename std::map<std::string, Type>::const_iterator Set<Type>::find(const std::string &key) const
+{
+	auto it = index.find(&key);
+	return (it == index.end() ? data.end() : it->second);
 }
 
 
@@ -74,7 +142,10 @@ void Set<Type>::Revert(const Set<Type> &other)
 	while(it != data.end())
 	{
 		if(oit == other.data.end() || it->first < oit->first)
+		{
+			index.erase(&it->first);
 			it = data.erase(it);
+		}
 		else if(it->first == oit->first)
 		{
 			// If this is an entry that is in the set we are reverting to, copy
@@ -91,4 +162,29 @@ void Set<Type>::Revert(const Set<Type> &other)
 
 
 
+template <class Type>
+typename std::map<std::string, Type>::iterator Set<Type>::Insert(const std::string &name) const
+{
+	auto it = index.find(&name);
+	if(it != index.end())
+		return it->second;
+
+	auto dit = data.emplace(std::piecewise_construct, std::forward_as_tuple(name), std::tuple<>()).first;
+	index.emplace(&dit->first, dit);
+	return dit;
+}
+
+
+
+template <class Type>
+void Set<Type>::Reindex()
+{
+	index.clear();
+	index.reserve(data.size());
+	for(auto it = data.begin(); it != data.end(); ++it)
+		index.emplace(&it->first, it);
+}
+
+
+
 #endif
@@ -43,7 +43,7 @@ const string &Sprite::Name() const
 
 
 // Upload the given frames. The given buffer will be cleared afterwards.
-void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
+void Sprite::AddFrames(ImageBuffer &buffer, bool is2x, bool enableUpload)
 {
 	// Do nothing if the buffer is empty.
 	if(!buffer.Pixels())
@@ -57,6 +57,13 @@ void Sprite::AddFrames(ImageBuffer &buffer, bool is2x)
 		frames = buffer.Frames();
 	}
 
+	// Without a graphics context, the image data is of no further use.
+	if(!enableUpload)
+	{
+		buffer.Clear();
+		return;
+	}
+
 	// Check whether this sprite is large enough to require size reduction.
 	if(Preferences::Has("Reduce large graphics") && buffer.Width() * buffer.Height() >= 1000000)
 		buffer.ShrinkToHalfSize();
@@ -36,7 +36,9 @@ public:
 	const std::string &Name() const;
 
 	// Upload the given frames. The given buffer will be cleared afterwards.
-	void AddFrames(ImageBuffer &buffer, bool is2x);
+	// If uploading is disabled (e.g. because there is no OpenGL context), only
+	// the dimensions of the frames are recorded.
+	void AddFrames(ImageBuffer &buffer, bool is2x, bool enableUpload = true);
 	// Free up all textures loaded for this sprite.
 	void Unload();
 
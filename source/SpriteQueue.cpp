@@ -20,6 +20,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Mask.h"
 #include "Sprite.h"
 #include "SpriteSet.h"
+#include "Tracer.h"
 
 #include <algorithm>
 #include <functional>
@@ -94,12 +95,23 @@ double SpriteQueue::GetProgress() const
 
 void SpriteQueue::UploadSprites()
 {
+	Tracer::Zone zone("SpriteQueue::UploadSprites");
 	unique_lock<mutex> lock(loadMutex);
 	DoLoad(lock);
 }
 
 
 
+// Stop uploading sprites to the GPU, e.g. because no window will be
+// created. Sprites will still receive their dimensions and masks.
+void SpriteQueue::PreventUpload()
+{
+	unique_lock<mutex> lock(loadMutex);
+	preventUpload = true;
+}
+
+
+
 // Finish loading.
 void SpriteQueue::Finish()
 {
@@ -124,6 +136,7 @@ void SpriteQueue::Finish()
 // Thread entry point.
 void SpriteQueue::operator()()
 {
+	Tracer::SetThreadName("sprite loader");
 	while(true)
 	{
 		unique_lock<mutex> lock(readMutex);
@@ -146,7 +159,10 @@ void SpriteQueue::operator()()
 			// Load the sprite.
 			// TODO: investigate catching exceptions from Load() (e.g. bad_alloc), to enable
 			// the UI thread to display a message prior to terminating the process.
-			imageSet->Load();
+			{
+				Tracer::Zone zone("ImageSet::Load");
+				imageSet->Load();
+			}
 
 			{
 				// The texture must be uploaded to OpenGL in the main thread.
@@ -171,6 +187,10 @@ void SpriteQueue::DoLoad(unique_lock<mutex> &lock)
 		Sprite *sprite = SpriteSet::Modify(toUnload.front());
 		toUnload.pop();
 
+		// Sprites that were never uploaded have no textures to free.
+		if(preventUpload)
+			continue;
+
 		lock.unlock();
 		sprite->Unload();
 		lock.lock();
@@ -181,11 +201,12 @@ void SpriteQueue::DoLoad(unique_lock<mutex> &lock)
 		// Extract the one item we should work on uploading right now.
 		shared_ptr<ImageSet> imageSet = toLoad.front();
 		toLoad.pop();
+		bool enableUpload = !preventUpload;
 
 		// It's now safe to modify the lists.
 		lock.unlock();
 
-		imageSet->Upload(SpriteSet::Modify(imageSet->Name()));
+		imageSet->Upload(SpriteSet::Modify(imageSet->Name()), enableUpload);
 
 		lock.lock();
 		++completed;
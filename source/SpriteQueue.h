@@ -53,6 +53,9 @@ public:
 	double GetProgress() const;
 	// Uploads any available sprites to the GPU.
 	void UploadSprites();
+	// Stop uploading sprites to the GPU, e.g. because no window will be
+	// created. Sprites will still receive their dimensions and masks.
+	void PreventUpload();
 	// Finish loading.
 	void Finish();
 
@@ -76,6 +79,7 @@ private:
 	std::mutex loadMutex;
 	std::condition_variable loadCondition;
 	int completed = 0;
+	bool preventUpload = false;
 
 	// These sprites must be unloaded to reclaim GPU memory.
 	std::queue<std::string> toUnload;
@@ -0,0 +1,144 @@
+/* StepProfile.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "StepProfile.h"
+
+#include "Files.h"
+#include "Tracer.h"
+
+using namespace std;
+
+namespace {
+	const string NAMES[StepProfile::PHASE_COUNT + 1] = {
+		"AI",
+		"ship movement",
+		"asteroids",
+		"projectiles",
+		"collision sets",
+		"collisions",
+		"radar",
+		"draw list",
+		"total"
+	};
+
+	double Milliseconds(chrono::steady_clock::duration duration)
+	{
+		return chrono::duration<double, milli>(duration).count();
+	}
+}
+
+
+
+// Get the name of the given phase. PHASE_COUNT stands for the whole step.
+const string &StepProfile::Name(int phase)
+{
+	return NAMES[(phase >= 0 && phase < PHASE_COUNT) ? phase : PHASE_COUNT];
+}
+
+
+
+StepProfile::StepProfile()
+	: history(HISTORY)
+{
+	current.fill(0.);
+	sums.fill(0.);
+}
+
+
+
+// Mark the start of a step.
+void StepProfile::BeginStep()
+{
+	current.fill(0.);
+	stepStart = chrono::steady_clock::now();
+}
+
+
+
+// Mark the end of a step, and add it to the history. Once the history is full,
+// this replaces the oldest step.
+void StepProfile::EndStep()
+{
+	current[PHASE_COUNT] = Milliseconds(chrono::steady_clock::now() - stepStart);
+
+	Times &slot = history[next];
+	for(size_t i = 0; i < slot.size(); ++i)
+		sums[i] += current[i] - (count == HISTORY ? slot[i] : 0.);
+	slot = current;
+
+	next = (next + 1) % HISTORY;
+	if(count < HISTORY)
+		++count;
+}
+
+
+
+// Mark the start of a phase of the current step.
+void StepProfile::Begin(Phase phase)
+{
+	this->phase = phase;
+	phaseStart = chrono::steady_clock::now();
+}
+
+
+
+// Mark the end of the phase that was most recently begun. If a trace is being
+// recorded, the phase is added to it, too.
+void StepProfile::End()
+{
+	chrono::steady_clock::time_point now = chrono::steady_clock::now();
+	current[phase] += Milliseconds(now - phaseStart);
+	Tracer::Record(Name(phase).c_str(), phaseStart, now);
+}
+
+
+
+// Get the number of steps that have been recorded, up to HISTORY.
+size_t StepProfile::Steps() const
+{
+	return count;
+}
+
+
+
+// Get the average time of the given phase, or of the whole step, over the
+// recorded steps.
+double StepProfile::Average(int phase) const
+{
+	return count ? sums[(phase >= 0 && phase < PHASE_COUNT) ? phase : PHASE_COUNT] / count : 0.;
+}
+
+
+
+// Write the recorded steps to a CSV file, oldest first.
+void StepProfile::Save(const string &path) const
+{
+	string out;
+	for(int i = 0; i <= PHASE_COUNT; ++i)
+		out += (i ? "," : "") + Name(i);
+	out += '\n';
+
+	// If the history is full, the oldest step is the one that would be
+	// overwritten next.
+	size_t first = (count == HISTORY ? next : 0);
+	for(size_t i = 0; i < count; ++i)
+	{
+		const Times &times = history[(first + i) % HISTORY];
+		for(size_t j = 0; j < times.size(); ++j)
+			out += (j ? "," : "") + to_string(times[j]);
+		out += '\n';
+	}
+	Files::Write(path, out);
+}
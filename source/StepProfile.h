@@ -0,0 +1,84 @@
+/* StepProfile.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef STEP_PROFILE_H_
+#define STEP_PROFILE_H_
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+
+
+// Class for measuring how long each phase of the Engine's calculation step
+// takes. The times of the most recent steps are kept in a ring buffer, so that
+// a phase that has become slow can be found without attaching a profiler.
+class StepProfile {
+public:
+	enum Phase {AI_STEP, SHIP_MOVEMENT, ASTEROIDS, PROJECTILES, COLLISION_SETS, COLLISIONS, RADAR, DRAW_LIST,
+		PHASE_COUNT};
+	// The number of steps to remember.
+	static const std::size_t HISTORY = 600;
+
+	// Get the name of the given phase. PHASE_COUNT stands for the whole step.
+	static const std::string &Name(int phase);
+
+
+public:
+	StepProfile();
+
+	// Mark the start and the end of a step.
+	void BeginStep();
+	void EndStep();
+	// Mark the start and the end of a phase of the current step. If a phase is
+	// entered more than once in a step, the times are added together.
+	void Begin(Phase phase);
+	void End();
+
+	// Get the number of steps that have been recorded, up to HISTORY.
+	std::size_t Steps() const;
+	// Get the average time of the given phase, or of the whole step if given
+	// PHASE_COUNT, over the recorded steps. Times are in milliseconds.
+	double Average(int phase) const;
+
+	// Write the recorded steps to a CSV file, oldest first, with one column for
+	// each phase and a final column for the whole step.
+	void Save(const std::string &path) const;
+
+
+private:
+	// The times of the phases of one step, followed by the total.
+	using Times = std::array<double, PHASE_COUNT + 1>;
+
+
+private:
+	std::chrono::steady_clock::time_point stepStart;
+	std::chrono::steady_clock::time_point phaseStart;
+	Phase phase = AI_STEP;
+	Times current;
+
+	std::vector<Times> history;
+	// The sum of each column of the history, so averages are cheap to find.
+	Times sums;
+	// The index in the history that the next step will be written to.
+	std::size_t next = 0;
+	std::size_t count = 0;
+};
+
+
+
+#endif
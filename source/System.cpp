@@ -27,8 +27,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "Planet.h"
 #include "Random.h"
 #include "SpriteSet.h"
+#include "SystemGrid.h"
+#include "Wormhole.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 
 using namespace std;
@@ -42,6 +45,13 @@ namespace {
 	const double VOLUME = 2000.;
 	// Above this supply amount, price differences taper off:
 	const double LIMIT = 20000.;
+
+	// The index that the next system to be created will be given.
+	atomic<unsigned> nextIndex(0);
+
+	// The longest hyperspace link and jump of any system.
+	double longestLink = 0.;
+	double longestJump = 0.;
 }
 
 const double System::DEFAULT_NEIGHBOR_DISTANCE = 100.;
@@ -90,6 +100,31 @@ double System::Asteroid::Energy() const
 
 
 
+// Get the longest distance on the map spanned by any accessible hyperspace
+// link, or by any jump to a neighbor at any of the jump ranges, of any system
+// that has been updated. These never decrease.
+double System::LongestLink()
+{
+	return longestLink;
+}
+
+
+
+double System::LongestJump()
+{
+	return longestJump;
+}
+
+
+
+// Give each system a number that stays the same for as long as it exists.
+System::System()
+	: index(nextIndex++)
+{
+}
+
+
+
 // Load a system's description.
 void System::Load(const DataNode &node, Set<Planet> &planets)
 {
@@ -154,7 +189,7 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 				ramscoopMultiplier = 1.;
 			}
 			else if(key == "trade")
-				trade.clear();
+				tradeBase.clear();
 			else if(key == "fleet")
 				fleets.clear();
 			else if(key == "hazard")
@@ -366,7 +401,7 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 		else if(key == "starfield density")
 			starfieldDensity = child.Value(valueIndex);
 		else if(key == "trade" && child.Size() >= 3)
-			trade[value].SetBase(child.Value(valueIndex + 1));
+			tradeBase[value] = child.Value(valueIndex + 1);
 		else if(key == "arrival")
 		{
 			if(child.Size() >= 2)
@@ -465,10 +500,11 @@ void System::Load(const DataNode &node, Set<Planet> &planets)
 // Update any information about the system that may have changed due to events,
 // or because the game was started, e.g. neighbors, solar wind and power, or
 // if the system is inhabited.
-void System::UpdateSystem(const Set<System> &systems, const set<double> &neighborDistances)
+void System::UpdateSystem(const SystemGrid &grid, const set<double> &neighborDistances)
 {
 	accessibleLinks.clear();
 	neighbors.clear();
+	UpdateTrade(GameData::Commodities());
 
 	// Some systems in the game may be considered inaccessible. If this system is inaccessible,
 	// then it shouldn't have accessible links or jump neighbors.
@@ -479,7 +515,10 @@ void System::UpdateSystem(const Set<System> &systems, const set<double> &neighbo
 	// set that gets used for navigation and other purposes.
 	for(const System *link : links)
 		if(!link->Inaccessible())
+		{
 			accessibleLinks.insert(link);
+			longestLink = max(longestLink, link->Position().Distance(position));
+		}
 
 	// Neighbors are cached for each system for the purpose of quicker
 	// pathfinding. If this system has a static jump range then that
@@ -488,15 +527,15 @@ void System::UpdateSystem(const Set<System> &systems, const set<double> &neighbo
 	// jump range that can be encountered.
 	if(jumpRange)
 	{
-		UpdateNeighbors(systems, jumpRange);
+		UpdateNeighbors(grid, jumpRange);
 		// Systems with a static jump range must also create a set for
 		// the DEFAULT_NEIGHBOR_DISTANCE to be returned for those systems
 		// which are visible from it.
-		UpdateNeighbors(systems, DEFAULT_NEIGHBOR_DISTANCE);
+		UpdateNeighbors(grid, DEFAULT_NEIGHBOR_DISTANCE);
 	}
 	else
 		for(const double distance : neighborDistances)
-			UpdateNeighbors(systems, distance);
+			UpdateNeighbors(grid, distance);
 
 	// Calculate the solar power and solar wind.
 	solarPower = 0.;
@@ -524,6 +563,23 @@ void System::UpdateSystem(const Set<System> &systems, const set<double> &neighbo
 
 
 
+// Find how far this system is from the nearest system that any of the given
+// wormholes leads to or from. This must be done whenever they change.
+void System::UpdateWormholeDistance(const Set<Wormhole> &wormholes)
+{
+	wormholeDistance = -1.;
+	for(const auto &it : wormholes)
+		for(const auto &link : it.second.Links())
+			for(const System *system : {link.first, link.second})
+			{
+				double distance = system->Position().Distance(position);
+				if(wormholeDistance < 0. || distance < wormholeDistance)
+					wormholeDistance = distance;
+			}
+}
+
+
+
 // Modify a system's links.
 void System::Link(System *other)
 {
@@ -551,6 +607,15 @@ bool System::IsValid() const
 
 
 
+// Get the number that identifies this system. Systems are numbered in the
+// order they were created, starting from zero.
+unsigned System::Index() const
+{
+	return index;
+}
+
+
+
 // Get this system's name.
 const string &System::Name() const
 {
@@ -621,6 +686,15 @@ const set<const System *> &System::JumpNeighbors(double neighborDistance) const
 
 
 
+// Get the distance on the map to the nearest system that a wormhole leads to
+// or from, or -1 if there are no wormholes.
+double System::WormholeDistance() const
+{
+	return wormholeDistance;
+}
+
+
+
 // Defines whether this system can be seen when not linked. A hidden system will
 // not appear when in view range, except when linked to a visited system.
 bool System::Hidden() const
@@ -872,57 +946,156 @@ const Sprite *System::Haze() const
 // Get the price of the given commodity in this system.
 int System::Trade(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.price;
+	int index = CommodityIndex(commodity);
+	return (index < 0 || static_cast<size_t>(index) >= prices.size()) ? 0 : prices[index];
 }
 
 
 
 bool System::HasTrade() const
 {
-	return !trade.empty();
+	return !tradeBase.empty();
+}
+
+
+
+// Match up the commodities traded here with the given list of all
+// commodities, keeping the current supply of each one. This is done with
+// GameData::Commodities() whenever the system is updated.
+void System::UpdateTrade(const vector<Trade::Commodity> &commodities)
+{
+	this->commodities = &commodities;
+	if(tradeBase.empty())
+	{
+		basePrices.clear();
+		prices.clear();
+		supply.clear();
+		exports.clear();
+		isTraded.clear();
+		return;
+	}
+
+	const size_t count = commodities.size();
+	basePrices.assign(count, 0);
+	prices.resize(count);
+	supply.resize(count, 0.);
+	exports.resize(count, 0.);
+	isTraded.assign(count, 0.);
+	for(size_t i = 0; i < count; ++i)
+	{
+		auto it = tradeBase.find(commodities[i].name);
+		if(it != tradeBase.end())
+		{
+			basePrices[i] = it->second;
+			isTraded[i] = 1.;
+		}
+		else
+		{
+			supply[i] = 0.;
+			exports[i] = 0.;
+		}
+	}
+	UpdatePrices();
 }
 
 
 
-// Update the economy.
+// Advance the economy of all the given systems by the given number of days.
+// The prices only depend on the supply, so they are only updated once.
+void System::StepEconomy(Set<System> &systems, int days)
+{
+	for(int day = 0; day < days; ++day)
+	{
+		// Have each system generate new goods for local use and trade.
+		for(auto &it : systems)
+			it.second.StepEconomy();
+
+		// Then, send out the trade goods. This has to be done in a separate step
+		// because otherwise whichever systems trade last would already have gotten
+		// supplied by the other systems.
+		for(auto &it : systems)
+			it.second.ImportTrade();
+	}
+
+	for(auto &it : systems)
+		it.second.UpdatePrices();
+}
+
+
+
+// Update the economy: work out how much of each trade good this system
+// exports today, and how much it keeps and produces.
 void System::StepEconomy()
 {
-	for(auto &it : trade)
+	const size_t count = supply.size();
+	for(size_t i = 0; i < count; ++i)
+	{
+		exports[i] = EXPORT * supply[i];
+		supply[i] *= KEEP;
+	}
+	for(size_t i = 0; i < count; ++i)
+		if(isTraded[i])
+			supply[i] += Random::Normal() * VOLUME;
+}
+
+
+
+// Add the goods that each linked system exported today to this system's
+// supply. Every system must be stepped before any of them import goods.
+void System::ImportTrade()
+{
+	const size_t count = supply.size();
+	double *in = supply.data();
+	const double *traded = isTraded.data();
+	for(const System *neighbor : accessibleLinks)
 	{
-		it.second.exports = EXPORT * it.second.supply;
-		it.second.supply *= KEEP;
-		it.second.supply += Random::Normal() * VOLUME;
-		it.second.Update();
+		// Each system's exports are split evenly between all its links. A
+		// system that trades nothing exports nothing.
+		double scale = neighbor->accessibleLinks.size();
+		if(!scale || neighbor->exports.size() != count)
+			continue;
+
+		const double *out = neighbor->exports.data();
+		for(size_t i = 0; i < count; ++i)
+			in[i] += traded[i] * (out[i] / scale);
 	}
 }
 
 
 
+// Update the price of each trade good to reflect the current supply.
+void System::UpdatePrices()
+{
+	for(size_t i = 0; i < prices.size(); ++i)
+		UpdatePrice(i);
+}
+
+
+
 void System::SetSupply(const string &commodity, double tons)
 {
-	auto it = trade.find(commodity);
-	if(it == trade.end())
+	int index = CommodityIndex(commodity);
+	if(index < 0 || static_cast<size_t>(index) >= supply.size() || !isTraded[index])
 		return;
 
-	it->second.supply = tons;
-	it->second.Update();
+	supply[index] = tons;
+	UpdatePrice(index);
 }
 
 
 
 double System::Supply(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.supply;
+	int index = CommodityIndex(commodity);
+	return (index < 0 || static_cast<size_t>(index) >= supply.size()) ? 0 : supply[index];
 }
 
 
 
 double System::Exports(const string &commodity) const
 {
-	auto it = trade.find(commodity);
-	return (it == trade.end()) ? 0 : it->second.exports;
+	int index = CommodityIndex(commodity);
+	return (index < 0 || static_cast<size_t>(index) >= exports.size()) ? 0 : exports[index];
 }
 
 
@@ -1027,7 +1200,7 @@ void System::LoadObjectHelper(const DataNode &node, StellarObject &object, bool
 // Once the star map is fully loaded or an event has changed systems
 // or links, figure out which stars are "neighbors" of this one, i.e.
 // close enough to see or to reach via jump drive.
-void System::UpdateNeighbors(const Set<System> &systems, double distance)
+void System::UpdateNeighbors(const SystemGrid &grid, double distance)
 {
 	set<const System *> &neighborSet = neighbors[distance];
 
@@ -1037,30 +1210,30 @@ void System::UpdateNeighbors(const Set<System> &systems, double distance)
 		neighborSet.insert(system);
 
 	// Any other star system that is within the neighbor distance is also a
-	// neighbor.
-	for(const auto &it : systems)
-	{
-		const System &other = it.second;
-		// Skip systems that have no name or that are inaccessible.
-		if(it.first.empty() || other.Name().empty() || other.Inaccessible())
-			continue;
-
-		if(&other != this && other.Position().Distance(position) <= distance)
-			neighborSet.insert(&other);
-	}
+	// neighbor. The grid only includes systems that can be neighbors.
+	for(const System *other : grid.Within(position, distance))
+		if(other != this)
+			neighborSet.insert(other);
+	for(const System *neighbor : neighborSet)
+		longestJump = max(longestJump, neighbor->Position().Distance(position));
 }
 
 
 
-void System::Price::SetBase(int base)
+// Get the index of the given commodity in the list of commodities that this
+// system's market was last matched up with, or -1 if it is not there.
+int System::CommodityIndex(const string &name) const
 {
-	this->base = base;
-	this->price = base;
+	if(commodities)
+		for(size_t i = 0; i < commodities->size(); ++i)
+			if((*commodities)[i].name == name)
+				return i;
+	return -1;
 }
 
 
 
-void System::Price::Update()
+void System::UpdatePrice(size_t commodity)
 {
-	price = base + static_cast<int>(-100. * erf(supply / LIMIT));
+	prices[commodity] = basePrices[commodity] + static_cast<int>(-100. * erf(supply[commodity] / LIMIT));
 }
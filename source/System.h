@@ -21,8 +21,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "RandomEvent.h"
 #include "Set.h"
 #include "StellarObject.h"
+#include "Trade.h"
 #include "WeightedList.h"
 
+#include <cstddef>
+#include <map>
 #include <set>
 #include <string>
 #include <vector>
@@ -35,6 +38,8 @@ class Minable;
 class Planet;
 class Ship;
 class Sprite;
+class SystemGrid;
+class Wormhole;
 
 
 
@@ -46,6 +51,12 @@ class System {
 public:
 	static const double DEFAULT_NEIGHBOR_DISTANCE;
 
+	// Get the longest distance on the map spanned by any accessible hyperspace
+	// link, or by any jump to a neighbor at any of the jump ranges, of any
+	// system that has been updated. These never decrease.
+	static double LongestLink();
+	static double LongestJump();
+
 public:
 	class Asteroid {
 	public:
@@ -66,17 +77,29 @@ public:
 
 
 public:
+	System();
+
 	// Load a system's description.
 	void Load(const DataNode &node, Set<Planet> &planets);
 	// Update any information about the system that may have changed due to events,
 	// e.g. neighbors, solar wind and power, or if the system is inhabited.
-	void UpdateSystem(const Set<System> &systems, const std::set<double> &neighborDistances);
+	// The grid must include all the systems that may be this system's neighbors.
+	void UpdateSystem(const SystemGrid &grid, const std::set<double> &neighborDistances);
+	// Find how far this system is from the nearest system that any of the given
+	// wormholes leads to or from. This must be done whenever they change.
+	void UpdateWormholeDistance(const Set<Wormhole> &wormholes);
 
 	// Modify a system's links.
 	void Link(System *other);
 	void Unlink(System *other);
 
 	bool IsValid() const;
+
+	// Get the number that identifies this system, for use as an index into
+	// arrays of information about each system. Systems are numbered in the
+	// order they were created, starting from zero, and a copy of a system
+	// shares its number.
+	unsigned Index() const;
 	// Get this system's name and position (in the star map).
 	const std::string &Name() const;
 	void SetName(const std::string &name);
@@ -96,6 +119,9 @@ public:
 	// If this system has its own jump range, then it will always return the
 	// systems within that jump range instead of the jump range given.
 	const std::set<const System *> &JumpNeighbors(double neighborDistance) const;
+	// Get the distance on the map to the nearest system that a wormhole leads
+	// to or from, or -1 if there are no wormholes.
+	double WormholeDistance() const;
 	// Defines whether this system can be seen when not linked. A hidden system will
 	// not appear when in view range, except when linked to a visited system.
 	bool Hidden() const;
@@ -156,8 +182,21 @@ public:
 	// Get the price of the given commodity in this system.
 	int Trade(const std::string &commodity) const;
 	bool HasTrade() const;
-	// Update the economy. Returns the amount of trade goods this system exports.
+	// Match up the commodities traded here with the given list of all
+	// commodities, keeping the current supply of each one. This is done with
+	// GameData::Commodities() whenever the system is updated.
+	void UpdateTrade(const std::vector<Trade::Commodity> &commodities);
+	// Advance the economy of all the given systems by the given number of days.
+	// The prices only depend on the supply, so they are only updated once.
+	static void StepEconomy(Set<System> &systems, int days);
+	// Update the economy: work out how much of each trade good this system
+	// exports today, and how much it keeps and produces.
 	void StepEconomy();
+	// Add the goods that each linked system exported today to this system's
+	// supply. Every system must be stepped before any of them import goods.
+	void ImportTrade();
+	// Update the price of each trade good to reflect the current supply.
+	void UpdatePrices();
 	void SetSupply(const std::string &commodity, double tons);
 	double Supply(const std::string &commodity) const;
 	double Exports(const std::string &commodity) const;
@@ -180,23 +219,15 @@ private:
 	// Once the star map is fully loaded or an event has changed systems
 	// or links, figure out which stars are "neighbors" of this one, i.e.
 	// close enough to see or to reach via jump drive.
-	void UpdateNeighbors(const Set<System> &systems, double distance);
-
-
-private:
-	class Price {
-	public:
-		void SetBase(int base);
-		void Update();
-
-		int base = 0;
-		int price = 0;
-		double supply = 0.;
-		double exports = 0.;
-	};
+	void UpdateNeighbors(const SystemGrid &grid, double distance);
+	// Get the index of the given commodity in the list of commodities that
+	// this system's market was last matched up with, or -1 if it is not there.
+	int CommodityIndex(const std::string &name) const;
+	void UpdatePrice(std::size_t commodity);
 
 
 private:
+	unsigned index;
 	bool isDefined = false;
 	bool hasPosition = false;
 	// Name and position (within the star map) of this system.
@@ -211,6 +242,8 @@ private:
 	std::set<const System *> accessibleLinks;
 	// Other systems that can be accessed from this system via a jump drive at various jump ranges.
 	std::map<double, std::set<const System *>> neighbors;
+	// How far away the nearest system that a wormhole leads to or from is.
+	double wormholeDistance = -1.;
 
 	// Defines whether this system can be seen when not linked. A hidden system will
 	// not appear when in view range, except when linked to a visited system.
@@ -258,8 +291,21 @@ private:
 	double jumpDepartureDistance = 0.;
 	double hyperDepartureDistance = 0.;
 
-	// Commodity prices.
-	std::map<std::string, Price> trade;
+	// The base price of each commodity traded here.
+	std::map<std::string, int> tradeBase;
+	// The list of all commodities that this system's market was matched up
+	// with, usually GameData::Commodities().
+	const std::vector<Trade::Commodity> *commodities = nullptr;
+	// The state of each commodity's market, indexed the same way as that list.
+	// These are rebuilt from the base prices whenever the system is updated,
+	// and are empty if nothing is traded.
+	std::vector<int> basePrices;
+	std::vector<int> prices;
+	std::vector<double> supply;
+	std::vector<double> exports;
+	// 1 for each commodity that is traded here and 0 for any others, so that the
+	// daily trade can be done for all commodities at once.
+	std::vector<double> isTraded;
 
 	// Attributes, for use in location filters.
 	std::set<std::string> attributes;
@@ -0,0 +1,94 @@
+/* SystemGrid.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SystemGrid.h"
+
+#include "Point.h"
+#include "System.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace std;
+
+namespace {
+	// Coordinates beyond this many cells from the origin are clamped, so that
+	// converting them to an integer cannot overflow.
+	const double MAX_CELL = numeric_limits<int>::max() / 2;
+}
+
+
+
+// Sort the systems into square grid cells of the given size.
+SystemGrid::SystemGrid(const Set<System> &systems, double cellSize)
+	: cellSize(max(cellSize, 1.))
+{
+	for(const auto &it : systems)
+	{
+		const System &system = it.second;
+		// Skip systems that have no name or that are inaccessible.
+		if(it.first.empty() || system.Name().empty() || system.Inaccessible())
+			continue;
+
+		const Point &position = system.Position();
+		cells.emplace_back(make_pair(Cell(position.Y()), Cell(position.X())), &system);
+	}
+	sort(cells.begin(), cells.end());
+}
+
+
+
+// Get all the systems within the given distance of the given point, in no
+// particular order.
+vector<const System *> SystemGrid::Within(const Point &center, double distance) const
+{
+	vector<const System *> result;
+	if(distance < 0.)
+		return result;
+
+	const int minX = Cell(center.X() - distance);
+	const int maxX = Cell(center.X() + distance);
+	const int minY = Cell(center.Y() - distance);
+	const int maxY = Cell(center.Y() + distance);
+
+	auto it = cells.begin();
+	for(int y = minY; y <= maxY; ++y)
+	{
+		// Skip straight to the first cell in this row that is in range. If
+		// there are no systems left in any of the rows, stop looking.
+		it = lower_bound(it, cells.end(), make_pair(make_pair(y, minX), static_cast<const System *>(nullptr)));
+		if(it == cells.end())
+			break;
+		// Skip any empty rows.
+		if(it->first.first > y)
+		{
+			y = it->first.first - 1;
+			continue;
+		}
+		for( ; it != cells.end() && it->first.first == y && it->first.second <= maxX; ++it)
+			if(it->second->Position().Distance(center) <= distance)
+				result.push_back(it->second);
+	}
+	return result;
+}
+
+
+
+// Get the row or column of the grid that the given coordinate falls in.
+int SystemGrid::Cell(double coordinate) const
+{
+	return static_cast<int>(floor(max(-MAX_CELL, min(MAX_CELL, coordinate / cellSize))));
+}
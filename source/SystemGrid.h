@@ -0,0 +1,58 @@
+/* SystemGrid.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SYSTEM_GRID_H_
+#define SYSTEM_GRID_H_
+
+#include "Set.h"
+
+#include <utility>
+#include <vector>
+
+class Point;
+class System;
+
+
+
+// A uniform grid over the positions of star systems, for finding all the
+// systems within a certain distance of a point without checking every system.
+// Only systems that can be the neighbors of others (i.e. that have a name and
+// are not inaccessible) are included. Any change to the map that adds, moves,
+// or hides a system makes the grid out of date, so it should be rebuilt then.
+class SystemGrid {
+public:
+	// Sort the systems into square grid cells of the given size.
+	SystemGrid(const Set<System> &systems, double cellSize);
+
+	// Get all the systems within the given distance of the given point, in
+	// no particular order.
+	std::vector<const System *> Within(const Point &center, double distance) const;
+
+
+private:
+	// Get the row or column of the grid that the given coordinate falls in.
+	int Cell(double coordinate) const;
+
+
+private:
+	double cellSize;
+	// The systems, sorted by the row and then the column of their grid cell.
+	// Each query only needs to look at a range of each row it covers.
+	std::vector<std::pair<std::pair<int, int>, const System *>> cells;
+};
+
+
+
+#endif
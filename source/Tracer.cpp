@@ -0,0 +1,210 @@
+/* Tracer.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Tracer.h"
+
+#include "Files.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace std;
+
+namespace {
+	// One recorded zone. Slots in the event buffer are handed out to threads
+	// with an atomic counter, so no lock is needed to record a zone.
+	class Event {
+	public:
+		const char *name = nullptr;
+		thread::id threadID;
+		Tracer::Clock::time_point start;
+		Tracer::Clock::time_point end;
+	};
+
+	// The maximum number of zones that can be recorded. Zones beyond this are
+	// counted, but not recorded.
+	const size_t CAPACITY = 1 << 19;
+
+	atomic<bool> enabled(false);
+	unique_ptr<Event[]> events;
+	atomic<size_t> reserved(0);
+	// The number of threads that are in the middle of recording a zone. Tracing
+	// does not stop until this drops to zero, so no thread can write to the
+	// buffer after the trace has been written out.
+	atomic<int> writers(0);
+	Tracer::Clock::time_point origin;
+
+	mutex nameMutex;
+	// Threads may be named while static objects are still being constructed,
+	// so the list of names is created the first time it is needed.
+	vector<pair<thread::id, const char *>> &ThreadNames()
+	{
+		static vector<pair<thread::id, const char *>> threadNames;
+		return threadNames;
+	}
+
+	double Microseconds(Tracer::Clock::duration duration)
+	{
+		return chrono::duration<double, micro>(duration).count();
+	}
+}
+
+
+
+Tracer::Zone::Zone(const char *name)
+	: name(name), isRecording(enabled.load(memory_order_relaxed))
+{
+	if(isRecording)
+		start = Clock::now();
+}
+
+
+
+Tracer::Zone::~Zone()
+{
+	if(isRecording)
+		Record(name, start, Clock::now());
+}
+
+
+
+// Check whether zones are currently being recorded.
+bool Tracer::IsEnabled()
+{
+	return enabled.load(memory_order_relaxed);
+}
+
+
+
+// Record a zone whose start and end times were measured elsewhere.
+void Tracer::Record(const char *name, Clock::time_point start, Clock::time_point end)
+{
+	if(!enabled.load(memory_order_relaxed))
+		return;
+
+	// Announce this writer before checking again whether tracing is enabled.
+	// Both this and stopping the trace use sequentially consistent operations,
+	// so either this thread sees that tracing has stopped, or the thread that
+	// stops it sees this writer and waits for it.
+	writers.fetch_add(1);
+	if(enabled.load())
+	{
+		size_t index = reserved.fetch_add(1, memory_order_relaxed);
+		if(index < CAPACITY)
+		{
+			Event &event = events[index];
+			event.name = name;
+			event.threadID = this_thread::get_id();
+			event.start = start;
+			event.end = end;
+		}
+	}
+	writers.fetch_sub(1, memory_order_release);
+}
+
+
+
+// Give the calling thread a name to show in the trace.
+void Tracer::SetThreadName(const char *name)
+{
+	lock_guard<mutex> lock(nameMutex);
+	ThreadNames().emplace_back(this_thread::get_id(), name);
+}
+
+
+
+// Begin recording zones, unless no file to write them to was given.
+Tracer::Tracer(const string &path)
+	: path(path)
+{
+	if(path.empty())
+		return;
+
+	// The buffer is kept for any later trace. No thread writes to it once
+	// tracing has stopped, so it is safe for it to be freed when the program exits.
+	if(!events)
+		events.reset(new Event[CAPACITY]);
+	reserved = 0;
+	origin = Clock::now();
+
+	SetThreadName("main");
+	enabled.store(true, memory_order_release);
+}
+
+
+
+// Stop recording, and write the trace to the file.
+Tracer::~Tracer()
+{
+	if(path.empty())
+		return;
+
+	// Wait for any thread that is still recording a zone to finish. After this,
+	// no other thread will touch the buffer.
+	enabled.store(false);
+	while(writers.load(memory_order_acquire))
+		this_thread::yield();
+	size_t total = reserved.load(memory_order_relaxed);
+	size_t count = min(total, CAPACITY);
+
+	// The trace format identifies threads by number, so number them in the
+	// order they are first seen.
+	map<thread::id, int> threadIDs;
+	auto ThreadID = [&threadIDs](thread::id id) -> int
+	{
+		return threadIDs.emplace(id, threadIDs.size() + 1).first->second;
+	};
+
+	// The ID of a thread that has exited may be reused by a later one, so a
+	// thread may have been given more than one name.
+	map<int, string> names;
+	{
+		lock_guard<mutex> lock(nameMutex);
+		for(const auto &it : ThreadNames())
+		{
+			string &name = names[ThreadID(it.first)];
+			if(name.empty())
+				name = it.second;
+			else if(name.find(it.second) == string::npos)
+				name += string(" / ") + it.second;
+		}
+	}
+
+	string out = "{\"traceEvents\":[\n";
+	out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"Endless Sky\"}}";
+	for(const auto &it : names)
+		out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + to_string(it.first)
+			+ ",\"args\":{\"name\":\"" + it.second + "\"}}";
+	for(size_t i = 0; i < count; ++i)
+	{
+		const Event &event = events[i];
+		out += ",\n{\"name\":\"" + string(event.name) + "\",\"ph\":\"X\",\"pid\":1,\"tid\":"
+			+ to_string(ThreadID(event.threadID))
+			+ ",\"ts\":" + to_string(Microseconds(event.start - origin))
+			+ ",\"dur\":" + to_string(Microseconds(event.end - event.start)) + "}";
+	}
+	out += "\n],\"displayTimeUnit\":\"ms\"}\n";
+	Files::Write(path, out);
+
+	if(total > count)
+		Logger::LogError("Trace buffer was full: " + to_string(total - count) + " zones were not recorded.");
+}
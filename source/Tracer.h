@@ -0,0 +1,79 @@
+/* Tracer.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TRACER_H_
+#define TRACER_H_
+
+#include <chrono>
+#include <string>
+
+
+
+// Class for recording what each of the game's threads is doing and when, so
+// that stalls between them (e.g. the main thread waiting on the Engine) can be
+// seen. Code marks the zones it wants to see with Tracer::Zone objects. While
+// a Tracer exists, those zones are recorded, and when it is destroyed they are
+// written to a file in the Chrome trace event format, which can be viewed with
+// chrome://tracing or Perfetto. Only one Tracer may exist at a time, and when
+// none does, a zone costs no more than checking a flag.
+class Tracer {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	// A zone of code, which is recorded from when this object is created until
+	// it is destroyed. The name must be a string literal, or at least must live
+	// until the trace has been written.
+	class Zone {
+	public:
+		explicit Zone(const char *name);
+		~Zone();
+
+		Zone(const Zone &other) = delete;
+		Zone &operator=(const Zone &other) = delete;
+
+	private:
+		const char *name;
+		Clock::time_point start;
+		bool isRecording;
+	};
+
+
+public:
+	// Check whether zones are currently being recorded.
+	static bool IsEnabled();
+	// Record a zone whose start and end times were measured elsewhere.
+	static void Record(const char *name, Clock::time_point start, Clock::time_point end);
+	// Give the calling thread a name to show in the trace. This can be done
+	// before tracing begins. The name must be a string literal.
+	static void SetThreadName(const char *name);
+
+
+public:
+	// Begin recording zones. If the path is empty, nothing is recorded.
+	explicit Tracer(const std::string &path);
+	// Stop recording, and write the trace to the file.
+	~Tracer();
+
+	Tracer(const Tracer &other) = delete;
+	Tracer &operator=(const Tracer &other) = delete;
+
+
+private:
+	std::string path;
+};
+
+
+
+#endif
@@ -15,6 +15,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 
 #include "UniverseObjects.h"
 
+#include "DataCache.h"
 #include "DataFile.h"
 #include "DataNode.h"
 #include "Files.h"
@@ -31,11 +32,17 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteQueue.h"
 #include "SpriteSet.h"
 #include "StarField.h"
+#include "SystemGrid.h"
+#include "Tracer.h"
+#include "WorkerPool.h"
 
 #include <algorithm>
+#include <condition_variable>
 #include <iterator>
 #include <map>
+#include <mutex>
 #include <set>
+#include <thread>
 #include <utility>
 #include <vector>
 
@@ -68,6 +75,20 @@ namespace {
 		it.second.SetName(it.first);
 		Warn(noun, it.first);
 	}
+
+	// Wait for a thread to finish when leaving the scope it was started in,
+	// even if that is because of an exception.
+	class JoinOnExit {
+	public:
+		explicit JoinOnExit(thread &t) : t(t) {}
+		~JoinOnExit() { if(t.joinable()) t.join(); }
+
+		JoinOnExit(const JoinOnExit &other) = delete;
+		JoinOnExit &operator=(const JoinOnExit &other) = delete;
+
+	private:
+		thread &t;
+	};
 }
 
 
@@ -81,6 +102,8 @@ future<void> UniverseObjects::Load(const vector<string> &sources, bool debugMode
 	// function (except for calling GetProgress which is safe due to the atomic).
 	return async(launch::async, [this, sources, debugMode]() noexcept -> void
 		{
+			Tracer::SetThreadName("data loader");
+			Tracer::Zone zone("UniverseObjects::Load");
 			vector<string> files;
 			for(const string &source : sources)
 			{
@@ -94,17 +117,79 @@ future<void> UniverseObjects::Load(const vector<string> &sources, bool debugMode
 						make_move_iterator(list.end()));
 			}
 
+			// Only text files contain game data.
+			files.erase(remove_if(files.begin(), files.end(), [](const string &path) -> bool
+				{
+					return path.length() < 4 || path.compare(path.length() - 4, 4, ".txt");
+				}), files.end());
+
+			// Each file can be parsed independently of the others, so they are all
+			// parsed at once by a pool of threads. Their contents must still be
+			// loaded in order, so that later definitions override earlier ones. The
+			// pool starts on the files in order, so each file is usually parsed by
+			// the time it is needed.
+			// Files that have not changed since they were last parsed are read
+			// from a cache of their contents instead. Any warnings about a file
+			// are held back until it is loaded, so that the warnings about
+			// different files are not mixed together.
+			DataCache cache(Files::Config() + "data cache");
+			vector<DataFile> parsed(files.size());
+			vector<vector<string>> warnings(files.size());
+			vector<bool> isParsed(files.size(), false);
+			mutex parsedMutex;
+			condition_variable parsedCondition;
+			thread parser([&files, &cache, &parsed, &warnings, &isParsed, &parsedMutex, &parsedCondition]() noexcept -> void
+				{
+					Tracer::SetThreadName("data parser");
+					WorkerPool pool;
+					pool.Run(files.size(), [&](size_t i) -> void
+						{
+							{
+								Tracer::Zone zone("UniverseObjects::ParseFile");
+								Logger::Capture capture(warnings[i]);
+								cache.Load(files[i], parsed[i]);
+							}
+							{
+								lock_guard<mutex> lock(parsedMutex);
+								isParsed[i] = true;
+							}
+							parsedCondition.notify_all();
+						});
+				});
+			JoinOnExit joinParser(parser);
+
 			const double step = 1. / (static_cast<int>(files.size()) + 1);
-			for(const auto &path : files)
+			for(size_t i = 0; i < files.size(); ++i)
 			{
-				LoadFile(path, debugMode);
+				{
+					unique_lock<mutex> lock(parsedMutex);
+					parsedCondition.wait(lock, [&isParsed, i] { return isParsed[i]; });
+				}
+				for(const string &warning : warnings[i])
+					Logger::LogError(warning);
+				{
+					Tracer::Zone zone("UniverseObjects::LoadFile");
+					LoadFile(parsed[i], files[i], debugMode);
+				}
+				// This file's nodes and warnings are no longer needed.
+				parsed[i] = DataFile();
+				warnings[i] = vector<string>();
 
 				// Increment the atomic progress by one step.
 				// We use acquire + release to prevent any reordering.
 				auto val = progress.load(memory_order_acquire);
 				progress.store(val + step, memory_order_release);
 			}
-			FinishLoading();
+			// Every file has been parsed by now, so the cache is no longer in use
+			// even if the parser thread has not quite finished.
+			cache.Save();
+			if(debugMode)
+				Logger::LogError("Loaded " + to_string(cache.Hits()) + " of " + to_string(files.size())
+					+ " data files from the cache.");
+			{
+				Tracer::Zone zone("UniverseObjects::FinishLoading");
+				FinishLoading();
+			}
 			progress = 1.;
 		});
 }
@@ -207,12 +292,15 @@ void UniverseObjects::Change(const DataNode &node)
 // (This must be done any time a GameEvent creates or moves a system.)
 void UniverseObjects::UpdateSystems()
 {
+	// Sort the systems into a grid once, so that each system's neighbors can be
+	// found without checking every other system.
+	const SystemGrid grid(systems, System::DEFAULT_NEIGHBOR_DISTANCE);
 	for(auto &it : systems)
 	{
 		// Skip systems that have no name.
 		if(it.first.empty() || it.second.Name().empty())
 			continue;
-		it.second.UpdateSystem(systems, neighborDistances);
+		it.second.UpdateSystem(grid, neighborDistances);
 
 		// If there were changes to a system there might have been a change to a legacy
 		// wormhole which we must handle.
@@ -220,6 +308,11 @@ void UniverseObjects::UpdateSystems()
 			if(object.GetPlanet())
 				planets.Get(object.GetPlanet()->TrueName())->FinishLoading(wormholes);
 	}
+
+	// Routes are estimated from how far each system is from any wormhole, so
+	// find that once all the wormholes are up to date.
+	for(auto &it : systems)
+		it.second.UpdateWormholeDistance(wormholes);
 }
 
 
@@ -333,13 +426,8 @@ void UniverseObjects::CheckReferences()
 
 
 
-void UniverseObjects::LoadFile(const string &path, bool debugMode)
+void UniverseObjects::LoadFile(const DataFile &data, const string &path, bool debugMode)
 {
-	// This is an ordinary file. Check to see if it is an image.
-	if(path.length() < 4 || path.compare(path.length() - 4, 4, ".txt"))
-		return;
-
-	DataFile data(path);
 	if(debugMode)
 		Logger::LogError("Parsing: " + path);
 
@@ -55,6 +55,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include <vector>
 
 
+class DataFile;
 class Panel;
 class Sprite;
 
@@ -89,7 +90,8 @@ public:
 
 
 private:
-	void LoadFile(const std::string &path, bool debugMode = false);
+	// Load the contents of a data file that has already been parsed.
+	void LoadFile(const DataFile &data, const std::string &path, bool debugMode = false);
 
 
 private:
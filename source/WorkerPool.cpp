@@ -0,0 +1,160 @@
+/* WorkerPool.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "WorkerPool.h"
+
+#include "Random.h"
+#include "Tracer.h"
+
+#include <algorithm>
+#include <cstdint>
+
+using namespace std;
+
+
+
+// Constructor, which allocates the worker threads.
+WorkerPool::WorkerPool(unsigned threadCount)
+	: nextItem(0)
+{
+	if(!threadCount)
+		threadCount = max(1u, thread::hardware_concurrency());
+
+	// The calling thread does its share of the work, too.
+	threads.resize(threadCount - 1);
+	for(thread &t : threads)
+		t = thread(ref(*this));
+}
+
+
+
+// Destructor, which waits for all worker threads to wrap up.
+WorkerPool::~WorkerPool()
+{
+	{
+		lock_guard<mutex> lock(workMutex);
+		quit = true;
+	}
+	workCondition.notify_all();
+	for(thread &t : threads)
+		t.join();
+}
+
+
+
+// Get the number of threads that share the work, including the caller.
+unsigned WorkerPool::Size() const
+{
+	return threads.size() + 1;
+}
+
+
+
+// Call the given function once for every index from 0 to count - 1, and
+// wait until every call has returned.
+void WorkerPool::Run(size_t count, const function<void(size_t)> &function)
+{
+	// Handing out the work is not worth it if there is only one item.
+	if(threads.empty() || count < 2)
+	{
+		for(size_t i = 0; i < count; ++i)
+			function(i);
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(workMutex);
+		work = &function;
+		workCount = count;
+		nextItem = 0;
+		busy = threads.size();
+		++generation;
+	}
+	workCondition.notify_all();
+
+	DoWork();
+
+	unique_lock<mutex> lock(workMutex);
+	doneCondition.wait(lock, [this] { return !busy; });
+	work = nullptr;
+}
+
+
+
+// As above, but give each call its own random number stream, derived from
+// the calling thread's generator, so that the numbers each call draws do
+// not depend on how many threads there are or which one made the call.
+void WorkerPool::RunSeeded(size_t count, const function<void(size_t)> &function)
+{
+	if(!count)
+		return;
+
+	// Draw the seeds before any generator is reseeded.
+	uint64_t base = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+	uint64_t resume = (static_cast<uint64_t>(Random::Int()) << 32) | Random::Int();
+	Run(count, [base, &function](size_t i)
+	{
+		Random::Seed(base + i * 0x9E3779B97F4A7C15ull);
+		function(i);
+	});
+
+	// The calling thread may have handled any of the calls, so continue from
+	// a known state.
+	Random::Seed(resume);
+}
+
+
+
+// Thread entry point.
+void WorkerPool::operator()()
+{
+	Tracer::SetThreadName("worker pool");
+	unsigned lastGeneration = 0;
+	while(true)
+	{
+		{
+			unique_lock<mutex> lock(workMutex);
+			workCondition.wait(lock, [this, &lastGeneration] { return quit || generation != lastGeneration; });
+			if(quit)
+				return;
+			lastGeneration = generation;
+		}
+
+		DoWork();
+
+		bool isLast = false;
+		{
+			lock_guard<mutex> lock(workMutex);
+			isLast = !--busy;
+		}
+		if(isLast)
+			doneCondition.notify_one();
+	}
+}
+
+
+
+// Process work items until none are left.
+void WorkerPool::DoWork()
+{
+	Tracer::Zone zone("WorkerPool::DoWork");
+	while(true)
+	{
+		size_t item = nextItem++;
+		if(item >= workCount)
+			break;
+		(*work)(item);
+	}
+}
@@ -0,0 +1,87 @@
+/* WorkerPool.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef WORKER_POOL_H_
+#define WORKER_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+// Class for spreading a batch of independent work items across a set of worker
+// threads. The thread that hands out the work also takes part in it, and does
+// not continue until every item has been processed. Which thread handles which
+// item is not predictable, so the work items must not depend on each other and
+// should write their results into separate, per-item slots.
+class WorkerPool {
+public:
+	// Create a pool with the given number of threads, including the calling
+	// thread. If the count is zero, one thread per available core is used.
+	explicit WorkerPool(unsigned threadCount = 0);
+	~WorkerPool();
+
+	// No moving or copying this class.
+	WorkerPool(const WorkerPool &other) = delete;
+	WorkerPool(WorkerPool &&other) = delete;
+	WorkerPool &operator=(const WorkerPool &other) = delete;
+	WorkerPool &operator=(WorkerPool &&other) = delete;
+
+	// Get the number of threads that share the work, including the caller.
+	unsigned Size() const;
+	// Call the given function once for every index from 0 to count - 1, and
+	// wait until every call has returned.
+	void Run(std::size_t count, const std::function<void(std::size_t)> &function);
+	// As above, but give each call its own random number stream, derived from
+	// the calling thread's generator, so that the numbers each call draws do
+	// not depend on how many threads there are or which one made the call.
+	// This only works if the random number generator is thread local.
+	void RunSeeded(std::size_t count, const std::function<void(std::size_t)> &function);
+
+	// Thread entry point.
+	void operator()();
+
+
+private:
+	// Process work items until none are left.
+	void DoWork();
+
+
+private:
+	std::vector<std::thread> threads;
+
+	std::mutex workMutex;
+	std::condition_variable workCondition;
+	std::condition_variable doneCondition;
+	// The batch of work currently being processed, if any.
+	const std::function<void(std::size_t)> *work = nullptr;
+	std::size_t workCount = 0;
+	std::atomic<std::size_t> nextItem;
+	// Each batch has a new generation number, so that the workers can tell
+	// when there is new work to do.
+	unsigned generation = 0;
+	// The number of worker threads that have not yet finished the current batch.
+	unsigned busy = 0;
+	bool quit = false;
+};
+
+
+
+#endif
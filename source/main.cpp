@@ -16,6 +16,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 */
 
 #include "Audio.h"
+#include "Benchmark.h"
 #include "Command.h"
 #include "Conversation.h"
 #include "ConversationPanel.h"
@@ -42,6 +43,7 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "SpriteShader.h"
 #include "Test.h"
 #include "TestContext.h"
+#include "Tracer.h"
 #include "UI.h"
 
 #include <chrono>
@@ -93,6 +95,7 @@ int main(int argc, char *argv[])
 	bool printTests = false;
 	bool printData = false;
 	bool noTestMute = false;
+	bool trace = false;
 	string testToRunName = "";
 
 	// Ensure that we log errors to the errors.txt file.
@@ -123,21 +126,29 @@ int main(int argc, char *argv[])
 			printTests = true;
 		else if(arg == "--nomute")
 			noTestMute = true;
+		else if(arg == "--trace")
+			trace = true;
 	}
 	printData = PrintData::IsPrintDataArgument(argv);
+	bool runBenchmark = Benchmark::IsBenchmarkArgument(argv);
 	Files::Init(argv);
 
+	// If requested, record what each thread is doing until the game exits.
+	Tracer tracer(trace ? Files::Config() + "trace.json" : "");
+
 	try {
 		// Load plugin preferences before game data if any.
 		Plugins::LoadSettings();
 
 		// Begin loading the game data.
+		// The benchmark needs the sprites for their collision masks, but it
+		// never creates a window to upload them to.
 		bool isConsoleOnly = loadOnly || printTests || printData;
-		future<void> dataLoading = GameData::BeginLoad(isConsoleOnly, debugMode);
+		future<void> dataLoading = GameData::BeginLoad(isConsoleOnly, debugMode, runBenchmark);
 
 		// If we are not using the UI, or performing some automated task, we should load
 		// all data now. (Sprites and sounds can safely be deferred.)
-		if(isConsoleOnly || !testToRunName.empty())
+		if(isConsoleOnly || runBenchmark || !testToRunName.empty())
 			dataLoading.wait();
 
 		if(!testToRunName.empty() && !GameData::Tests().Has(testToRunName))
@@ -156,6 +167,8 @@ int main(int argc, char *argv[])
 			PrintTestsTable();
 			return 0;
 		}
+		if(runBenchmark)
+			return Benchmark::Run(argv);
 
 		PlayerInfo player;
 		if(loadOnly)
@@ -271,6 +284,7 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 	// IsDone becomes true when the game is quit.
 	while(!menuPanels.IsDone())
 	{
+		Tracer::Zone frameZone("frame");
 		if(toggleTimeout)
 			--toggleTimeout;
 		chrono::steady_clock::time_point start = chrono::steady_clock::now();
@@ -414,12 +428,18 @@ void GameLoop(PlayerInfo &player, const Conversation &conversation, const string
 		if(isFastForward)
 			SpriteShader::Draw(SpriteSet::Get("ui/fast forward"), Screen::TopLeft() + Point(10., 10.));
 
-		GameWindow::Step();
+		{
+			Tracer::Zone zone("GameWindow::Step");
+			GameWindow::Step();
+		}
 
 		// When we perform automated testing, then we run the game by default as quickly as possible.
 		// Except when debug-mode is set.
 		if(!testContext.CurrentTest() || debugMode)
+		{
+			Tracer::Zone zone("FrameTimer::Wait");
 			timer.Wait();
+		}
 
 		// If the player ended this frame in-game, count the elapsed time as played time.
 		if(menuPanels.IsEmpty())
@@ -447,7 +467,9 @@ void PrintHelp()
 	cerr << "    --tests: print table of available tests, then exit." << endl;
 	cerr << "    --test <name>: run given test from resources directory." << endl;
 	cerr << "    --nomute: don't mute the game while running tests." << endl;
+	cerr << "    --trace: record what each thread is doing, and write it to \"trace.json\" in the config directory on exit." << endl;
 	PrintData::Help();
+	Benchmark::Help();
 	cerr << endl;
 	cerr << "Report bugs to: <https://github.com/endless-sky/endless-sky/issues>" << endl;
 	cerr << "Home page: <https://endless-sky.github.io>" << endl;
@@ -0,0 +1,49 @@
+/* datafile-helpers.h
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ES_TEST_HELPER_DATAFILE_HELPERS_H_
+#define ES_TEST_HELPER_DATAFILE_HELPERS_H_
+
+#include <string>
+#include <vector>
+
+class DataFile;
+class DataNode;
+
+
+
+// Get the size and tokens of every node in the given file, in order, with a
+// marker after each node's children. Two files with the same nodes give the
+// same list.
+std::vector<std::string> Flatten(const DataFile &file);
+void Flatten(const DataNode &node, std::vector<std::string> &result);
+
+// Get the paths of all the game's data files.
+std::vector<std::string> DataFiles();
+
+// Write the given text to a file that is deleted again once it is no longer needed.
+class TemporaryFile {
+public:
+	TemporaryFile(const std::string &path, const std::string &text);
+	~TemporaryFile();
+
+	void Write(const std::string &text) const;
+
+	const std::string path;
+};
+
+
+
+#endif
@@ -0,0 +1,85 @@
+/* datafile-helpers.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "datafile-helpers.h"
+
+#include "../../../../source/DataFile.h"
+#include "../../../../source/DataNode.h"
+#include "../../../../source/Files.h"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+
+
+// Get the size and tokens of every node in the given file, in order, with a
+// marker after each node's children. Two files with the same nodes give the
+// same list.
+std::vector<std::string> Flatten(const DataFile &file)
+{
+	std::vector<std::string> result;
+	for(const DataNode &node : file)
+		Flatten(node, result);
+	return result;
+}
+
+
+
+void Flatten(const DataNode &node, std::vector<std::string> &result)
+{
+	result.push_back(std::to_string(node.Size()));
+	for(const std::string &token : node.Tokens())
+		result.push_back(token);
+	for(const DataNode &child : node)
+		Flatten(child, result);
+	result.push_back("end");
+}
+
+
+
+// Get the paths of all the game's data files.
+std::vector<std::string> DataFiles()
+{
+	std::vector<std::string> paths;
+	for(const std::string &path : Files::RecursiveList("../data/"))
+		if(path.size() > 4 && path.compare(path.size() - 4, 4, ".txt") == 0)
+			paths.push_back(path);
+	return paths;
+}
+
+
+
+// Write the given text to a file that is deleted again once it is no longer needed.
+TemporaryFile::TemporaryFile(const std::string &path, const std::string &text)
+	: path(path)
+{
+	Write(text);
+}
+
+
+
+TemporaryFile::~TemporaryFile()
+{
+	std::remove(path.c_str());
+}
+
+
+
+void TemporaryFile::Write(const std::string &text) const
+{
+	std::ofstream(path, std::ios::binary) << text;
+}
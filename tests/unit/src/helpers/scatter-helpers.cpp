@@ -0,0 +1,34 @@
+/* scatter-helpers.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "scatter-helpers.h"
+
+
+
+// A simple hash of the given number, for laying out test data in a way that
+// looks random but is the same from run to run.
+std::size_t Hash(std::size_t i)
+{
+	return i * 2654435761u;
+}
+
+
+
+// A repeatable, scattered sequence of values between -1 and 1.
+double Scatter(std::size_t i, std::size_t salt)
+{
+	std::size_t hash = (Hash(i) + salt * 40503u) % 100003u;
+	return hash / 50001.5 - 1.;
+}
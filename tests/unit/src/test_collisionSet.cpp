@@ -0,0 +1,317 @@
+/* test_collisionSet.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/CollisionSet.h"
+
+// Include a helper for laying out test data.
+#include "scatter-helpers.h"
+
+// ... and any other headers needed to create bodies.
+#include "../../../source/Body.h"
+#include "../../../source/GameData.h"
+#include "../../../source/ImageBuffer.h"
+#include "../../../source/Mask.h"
+#include "../../../source/MaskManager.h"
+#include "../../../source/Point.h"
+#include "../../../source/Sprite.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// A body that can be moved around freely.
+class TestBody : public Body {
+public:
+	TestBody(const Sprite *sprite, Point position) : Body(sprite, position) {}
+
+	void MoveTo(Point position) { this->position = position; }
+	void Step() { position += velocity; }
+	void SetVelocity(Point velocity) { this->velocity = velocity; }
+};
+
+// A sprite with dimensions but no image data.
+const Sprite *GetSprite()
+{
+	static Sprite sprite;
+	if(!sprite.Width())
+	{
+		ImageBuffer buffer;
+		buffer.Allocate(40, 40);
+		sprite.AddFrames(buffer, false, false);
+	}
+	return &sprite;
+}
+
+// A sprite with a collision mask in the shape of a filled square.
+const Sprite *GetMaskedSprite()
+{
+	static Sprite sprite;
+	if(!sprite.Width())
+	{
+		ImageBuffer buffer;
+		buffer.Allocate(40, 40);
+		for(int y = 0; y < 40; ++y)
+			for(int x = 0; x < 40; ++x)
+				buffer.Begin(y)[x] = (x >= 4 && x < 36 && y >= 4 && y < 36) ? 0xFFFFFFFFu : 0u;
+		std::vector<Mask> masks(1);
+		masks.front().Create(buffer);
+
+		MaskManager &manager = GameData::GetMaskManager();
+		manager.SetMasks(&sprite, std::move(masks));
+		manager.UpdateMasks();
+		manager.RegisterScale(&sprite, 1.);
+		sprite.AddFrames(buffer, false, false);
+	}
+	return &sprite;
+}
+
+// Create bodies scattered over an area, each with its own small velocity.
+std::vector<TestBody> MakeBodies(std::size_t count, double area, const Sprite *sprite = GetSprite())
+{
+	std::vector<TestBody> bodies;
+	bodies.reserve(count);
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		std::size_t hash = Hash(i);
+		Point position((hash % 4093) * area / 4093., ((hash / 4093) % 4091) * area / 4091.);
+		bodies.emplace_back(sprite, position);
+		bodies.back().SetVelocity(Point(static_cast<double>(hash % 7) - 3., static_cast<double>(hash % 5) - 2.));
+	}
+	return bodies;
+}
+
+std::vector<Body *> Sorted(std::vector<Body *> objects)
+{
+	std::sort(objects.begin(), objects.end());
+	return objects;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Keeping objects in a CollisionSet from step to step", "[CollisionSet]" ) {
+	GIVEN( "a collision set with inserted bodies" ) {
+		CollisionSet set(256, 32);
+		TestBody first(GetSprite(), Point(100., 100.));
+		TestBody second(GetSprite(), Point(1000., 1000.));
+		unsigned firstHandle = set.Insert(first);
+		unsigned secondHandle = set.Insert(second);
+		set.Update(0);
+
+		THEN( "each body has its own handle" ) {
+			CHECK( firstHandle != secondHandle );
+		}
+		THEN( "the bodies can be found" ) {
+			CHECK( set.All().size() == 2 );
+			CHECK( set.Circle(Point(100., 100.), 10.) == std::vector<Body *>{&first} );
+			CHECK( set.Circle(Point(1000., 1000.), 10.) == std::vector<Body *>{&second} );
+		}
+		WHEN( "a body moves to a different grid cell" ) {
+			first.MoveTo(Point(2000., 100.));
+			set.Update(1);
+			THEN( "it is found at its new position" ) {
+				CHECK( set.Circle(Point(2000., 100.), 10.) == std::vector<Body *>{&first} );
+				CHECK( set.Circle(Point(100., 100.), 10.).empty() );
+			}
+		}
+		WHEN( "a body is removed" ) {
+			set.Remove(firstHandle);
+			set.Update(1);
+			THEN( "it can no longer be found" ) {
+				CHECK( set.All() == std::vector<Body *>{&second} );
+				CHECK( set.Circle(Point(100., 100.), 10.).empty() );
+			}
+			AND_WHEN( "another body is inserted" ) {
+				TestBody third(GetSprite(), Point(100., 100.));
+				unsigned thirdHandle = set.Insert(third);
+				set.Update(2);
+				THEN( "the removed body's handle is reused" ) {
+					CHECK( thirdHandle == firstHandle );
+					CHECK( set.Circle(Point(100., 100.), 10.) == std::vector<Body *>{&third} );
+				}
+			}
+		}
+		WHEN( "the set is cleared" ) {
+			set.Clear(1);
+			THEN( "it is empty" ) {
+				CHECK( set.All().empty() );
+				CHECK( set.Circle(Point(100., 100.), 10.).empty() );
+			}
+		}
+	}
+	GIVEN( "many moving bodies" ) {
+		std::vector<TestBody> bodies = MakeBodies(500, 3000.);
+		CollisionSet rebuilt(256, 32);
+		CollisionSet incremental(256, 32);
+		for(TestBody &body : bodies)
+			incremental.Insert(body);
+		WHEN( "both ways of filling a set are used for many steps" ) {
+			bool allMatch = true;
+			for(int step = 0; step < 100; ++step)
+			{
+				for(TestBody &body : bodies)
+					body.Step();
+				rebuilt.Clear(step);
+				for(TestBody &body : bodies)
+					rebuilt.Add(body);
+				rebuilt.Finish();
+				incremental.Update(step);
+
+				for(int y = 0; y < 3000; y += 250)
+					for(int x = 0; x < 3000; x += 250)
+					{
+						Point center(x, y);
+						allMatch &= (Sorted(rebuilt.Circle(center, 200.)) == Sorted(incremental.Circle(center, 200.)));
+					}
+			}
+			THEN( "queries give the same results" ) {
+				CHECK( allMatch );
+				CHECK( Sorted(rebuilt.All()) == Sorted(incremental.All()) );
+			}
+		}
+	}
+}
+
+SCENARIO( "Resolving a batch of line queries", "[CollisionSet]" ) {
+	GIVEN( "a collision set with bodies that have collision masks" ) {
+		std::vector<TestBody> bodies = MakeBodies(300, 2000., GetMaskedSprite());
+		CollisionSet set(256, 32);
+		set.Clear(0);
+		for(TestBody &body : bodies)
+			set.Add(body);
+		set.Finish();
+
+		// Lines of all lengths, in all directions, scattered over the same area.
+		// Every other line is short, so that many lie within one grid cell.
+		std::vector<CollisionSet::LineQuery> queries;
+		for(std::size_t i = 0; i < 2000; ++i)
+		{
+			std::size_t hash = (i + 17) * 2246822519u;
+			Point from((hash % 2003) * 1., ((hash / 2003) % 1999) * 1.);
+			Point to = from + Point(static_cast<double>(hash % 601) - 300., static_cast<double>(hash % 401) - 200.)
+				* (i % 2 ? 1. : .05);
+			queries.emplace_back(from, to, nullptr, nullptr, i);
+		}
+		std::vector<CollisionSet::LineQuery> sorted = queries;
+
+		WHEN( "the batch is sorted and resolved" ) {
+			set.Sort(sorted);
+			set.Lines(sorted.data(), sorted.data() + sorted.size());
+			THEN( "each query has the same result as a separate line check" ) {
+				REQUIRE( sorted.size() == queries.size() );
+				std::size_t hits = 0;
+				bool allMatch = true;
+				for(const CollisionSet::LineQuery &query : sorted)
+				{
+					const CollisionSet::LineQuery &original = queries[query.index];
+					double closestHit = 1.;
+					Body *hit = set.Line(original.from, original.to, &closestHit);
+					allMatch &= (hit == query.hit && closestHit == query.closestHit);
+					hits += (hit != nullptr);
+				}
+				CHECK( allMatch );
+				// Make sure that the comparison was not trivial.
+				CHECK( hits > 0 );
+				CHECK( hits < queries.size() );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark CollisionSet rebuilding and updating", "[!benchmark][CollisionSet]" ) {
+	for(std::size_t count : {100, 1000, 10000})
+	{
+		std::vector<TestBody> bodies = MakeBodies(count, 8192.);
+		CollisionSet rebuilt(256, 32);
+		CollisionSet incremental(256, 32);
+		for(TestBody &body : bodies)
+			incremental.Insert(body);
+		int step = 0;
+
+		BENCHMARK( "Clear, Add, and Finish " + std::to_string(count) + " bodies" ) {
+			for(TestBody &body : bodies)
+				body.Step();
+			rebuilt.Clear(++step);
+			for(TestBody &body : bodies)
+				rebuilt.Add(body);
+			rebuilt.Finish();
+			return rebuilt.All().size();
+		};
+		BENCHMARK( "Update " + std::to_string(count) + " inserted bodies" ) {
+			for(TestBody &body : bodies)
+				body.Step();
+			incremental.Update(++step);
+			return incremental.All().size();
+		};
+	}
+}
+
+TEST_CASE( "Benchmark CollisionSet line queries", "[!benchmark][CollisionSet]" ) {
+	std::vector<TestBody> bodies = MakeBodies(200, 4000., GetMaskedSprite());
+	CollisionSet set(256, 32);
+	set.Clear(0);
+	for(TestBody &body : bodies)
+		set.Add(body);
+	set.Finish();
+
+	// Short segments, like those of flak fragments, scattered over the area.
+	std::vector<CollisionSet::LineQuery> queries;
+	for(std::size_t i = 0; i < 5000; ++i)
+	{
+		std::size_t hash = (i + 17) * 2246822519u;
+		Point from((hash % 4001) * 1., ((hash / 4001) % 3989) * 1.);
+		Point to = from + Point(static_cast<double>(hash % 41) - 20., static_cast<double>(hash % 37) - 18.);
+		queries.emplace_back(from, to, nullptr, nullptr, i);
+	}
+
+	BENCHMARK( "Line, once per segment" ) {
+		std::size_t hits = 0;
+		for(const CollisionSet::LineQuery &query : queries)
+			hits += (set.Line(query.from, query.to) != nullptr);
+		return hits;
+	};
+	BENCHMARK( "Lines, for all segments" ) {
+		set.Lines(queries.data(), queries.data() + queries.size());
+		return queries.size();
+	};
+	set.Sort(queries);
+	BENCHMARK( "Lines, for all segments after sorting them" ) {
+		set.Lines(queries.data(), queries.data() + queries.size());
+		return queries.size();
+	};
+	BENCHMARK( "Sort" ) {
+		set.Sort(queries);
+		return queries.size();
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
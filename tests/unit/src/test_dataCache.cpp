@@ -0,0 +1,172 @@
+/* test_dataCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/DataCache.h"
+
+// Include helper functions.
+#include "datafile-helpers.h"
+
+// ... and any other headers needed to load data files.
+#include "../../../source/DataFile.h"
+#include "../../../source/DataNode.h"
+#include "../../../source/Files.h"
+
+// ... and any system includes needed for the test file.
+#include <cstddef>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region unit tests
+SCENARIO( "Loading data files through a cache", "[DataCache]" ) {
+	const TemporaryFile first("test_dataCache_first.txt", "ship \"A\"\n\tattributes\n\t\tmass 10\n");
+	const TemporaryFile second("test_dataCache_second.txt", "outfit B\n\tcost 5 # comment\n");
+	const TemporaryFile cacheFile("test_dataCache_cache", "");
+	std::remove(cacheFile.path.c_str());
+
+	GIVEN( "a cache that does not exist yet" ) {
+		std::vector<DataFile> files(2);
+		{
+			DataCache cache(cacheFile.path);
+			cache.Load(first.path, files[0]);
+			cache.Load(second.path, files[1]);
+			cache.Save();
+			CHECK( cache.Hits() == 0 );
+			CHECK( cache.Misses() == 2 );
+		}
+		THEN( "the files are parsed" ) {
+			CHECK( Flatten(files[0]) == Flatten(DataFile(first.path)) );
+			CHECK( Flatten(files[1]) == Flatten(DataFile(second.path)) );
+		}
+		AND_WHEN( "the same files are loaded again" ) {
+			DataCache cache(cacheFile.path);
+			std::vector<DataFile> again(2);
+			cache.Load(first.path, again[0]);
+			cache.Load(second.path, again[1]);
+			THEN( "they are read from the cache, with the same contents" ) {
+				CHECK( cache.Hits() == 2 );
+				CHECK( cache.Misses() == 0 );
+				CHECK( Flatten(again[0]) == Flatten(files[0]) );
+				CHECK( Flatten(again[1]) == Flatten(files[1]) );
+				CHECK( again[0].begin()->Token(0) == "ship" );
+			}
+		}
+		AND_WHEN( "one of the files changes but keeps its size" ) {
+			first.Write("ship \"A\"\n\tattributes\n\t\tmass 20\n");
+			DataCache cache(cacheFile.path);
+			DataFile changed;
+			cache.Load(first.path, changed);
+			THEN( "it is parsed again" ) {
+				CHECK( cache.Misses() == 1 );
+				CHECK( Flatten(changed) == Flatten(DataFile(first.path)) );
+			}
+		}
+		AND_WHEN( "one of the files changes size" ) {
+			first.Write("ship \"A\"\n\tattributes\n\t\tmass 200\n");
+			DataCache cache(cacheFile.path);
+			DataFile changed;
+			cache.Load(first.path, changed);
+			THEN( "it is parsed again" ) {
+				CHECK( cache.Misses() == 1 );
+				CHECK( Flatten(changed) == Flatten(DataFile(first.path)) );
+			}
+		}
+	}
+	GIVEN( "a cache that has a file with warnings" ) {
+		const TemporaryFile warning("test_dataCache_warning.txt", "ship \"A\n");
+		{
+			DataCache cache(cacheFile.path);
+			DataFile files[2];
+			cache.Load(first.path, files[0]);
+			cache.Load(warning.path, files[1]);
+			cache.Save();
+		}
+		// Mark the end of the cache, to tell whether it gets replaced.
+		std::ofstream(cacheFile.path, std::ios::binary | std::ios::app) << "marker";
+		const std::size_t size = Files::Size(cacheFile.path);
+		WHEN( "the same files are loaded again" ) {
+			DataCache cache(cacheFile.path);
+			DataFile files[2];
+			cache.Load(first.path, files[0]);
+			cache.Load(warning.path, files[1]);
+			cache.Save();
+			THEN( "only the file with warnings is parsed again, and the cache is not replaced" ) {
+				CHECK( cache.Hits() == 1 );
+				CHECK( cache.Misses() == 1 );
+				CHECK( Files::Size(cacheFile.path) == size );
+			}
+		}
+	}
+	GIVEN( "a cache file that is not valid" ) {
+		std::ofstream(cacheFile.path, std::ios::binary) << "Endless Sky data cache 2\n\x05garbage";
+		DataCache cache(cacheFile.path);
+		DataFile file;
+		cache.Load(first.path, file);
+		THEN( "the file is parsed instead" ) {
+			CHECK( cache.Misses() == 1 );
+			CHECK( Flatten(file) == Flatten(DataFile(first.path)) );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark loading the game's data files through a cache", "[!benchmark][DataCache]" ) {
+	const std::vector<std::string> paths = DataFiles();
+	const TemporaryFile cacheFile("test_dataCache_benchmark", "");
+	std::remove(cacheFile.path.c_str());
+	{
+		DataCache cache(cacheFile.path);
+		std::vector<DataFile> files(paths.size());
+		for(std::size_t i = 0; i < paths.size(); ++i)
+			cache.Load(paths[i], files[i]);
+		cache.Save();
+	}
+
+	BENCHMARK( "Parse " + std::to_string(paths.size()) + " files" ) {
+		std::size_t nodes = 0;
+		for(const std::string &path : paths)
+		{
+			const DataFile file(path);
+			nodes += std::distance(file.begin(), file.end());
+		}
+		return nodes;
+	};
+	BENCHMARK( "Load " + std::to_string(paths.size()) + " files from the cache" ) {
+		DataCache cache(cacheFile.path);
+		std::size_t nodes = 0;
+		for(const std::string &path : paths)
+		{
+			DataFile file;
+			cache.Load(path, file);
+			nodes += std::distance(file.begin(), file.end());
+		}
+		return nodes;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
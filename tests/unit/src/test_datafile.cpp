@@ -19,12 +19,16 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/DataFile.h"
 
 // Include a helper functions.
+#include "datafile-helpers.h"
 #include "datanode-factory.h"
+#include "../../../source/DataNode.h"
+#include "../../../source/Files.h"
 #include "../../../source/text/Format.h"
 #include "output-capture.hpp"
 
 // ... and any system includes needed for the test file.
 #include <algorithm>
+#include <cstddef>
 #include <iterator>
 #include <set>
 #include <sstream>
@@ -288,8 +292,146 @@ now with
 		}
 	}
 }
+
+SCENARIO( "Loading a DataFile with malformed UTF-8", "[DataFile]" ) {
+	OutputSink sink(std::cerr);
+
+	GIVEN( "overlong encodings of a newline, a space, and a quotation mark" ) {
+		std::istringstream stream("first \xc0\x8asecond\n"
+			"\"a\xc0\xa2\xc0\xa0" "b\" c\n");
+		const DataFile root(stream);
+
+		THEN( "they are part of the tokens they are in, rather than separating them" ) {
+			REQUIRE( std::distance(root.begin(), root.end()) == 2 );
+			const DataNode &first = *root.begin();
+			REQUIRE( first.Size() == 2 );
+			CHECK( first.Token(0) == "first" );
+			CHECK( first.Token(1) == "\xc0\x8asecond" );
+			const DataNode &second = *std::next(root.begin());
+			REQUIRE( second.Size() == 2 );
+			CHECK( second.Token(0) == "a\xc0\xa2\xc0\xa0" "b" );
+			CHECK( second.Token(1) == "c" );
+			CHECK( Split(sink.Flush()).empty() );
+		}
+	}
+
+	GIVEN( "characters that are cut short by a newline or a quotation mark" ) {
+		std::istringstream stream("cut\xc3\n"
+			"\"cut\xe2\x82\" short\n");
+		const DataFile root(stream);
+
+		THEN( "the newline or quotation mark still ends the token" ) {
+			REQUIRE( std::distance(root.begin(), root.end()) == 2 );
+			const DataNode &first = *root.begin();
+			REQUIRE( first.Size() == 1 );
+			CHECK( first.Token(0) == "cut\xc3" );
+			const DataNode &second = *std::next(root.begin());
+			REQUIRE( second.Size() == 2 );
+			CHECK( second.Token(0) == "cut\xe2\x82" );
+			CHECK( second.Token(1) == "short" );
+			CHECK( Split(sink.Flush()).empty() );
+		}
+	}
+}
+
+SCENARIO( "Loading a DataFile from a path", "[DataFile]" ) {
+	OutputSink sink(std::cerr);
+	const std::string text = "system \"Sol\" # comment\n"
+		"\tpos 1.5 -2\n"
+		"\n"
+		"\t# indented comment\n"
+		"\tdescription `He said \"hi\".` \"\" \"caf\xc3\xa9\"\n"
+		"\t\tgrand\tchild\x01x \xff\xfe\n"
+		"\tlast \"unfinished";
+
+	GIVEN( "a file that does not end in a newline" ) {
+		const TemporaryFile file("test_datafile_path.txt", text);
+		const DataFile fromPath(file.path);
+		const auto pathWarnings = Split(sink.Flush());
+		std::istringstream stream(text);
+		const DataFile fromStream(stream);
+		const auto streamWarnings = Split(sink.Flush());
+
+		THEN( "it has the same nodes as when it is read from a stream" ) {
+			CHECK( Flatten(fromStream) == Flatten(fromPath) );
+			REQUIRE( std::distance(fromPath.begin(), fromPath.end()) == 1 );
+			const DataNode &system = *fromPath.begin();
+			CHECK( system.Token(1) == "Sol" );
+			REQUIRE( std::distance(system.begin(), system.end()) == 3 );
+			const DataNode &description = *std::next(system.begin());
+			REQUIRE( description.Size() == 4 );
+			CHECK( description.Token(1) == "He said \"hi\"." );
+			CHECK( description.Token(2).empty() );
+			CHECK( description.Token(3) == "caf\xc3\xa9" );
+			CHECK( std::prev(system.end())->Token(1) == "unfinished" );
+		}
+		THEN( "the same warnings are printed, and errors show which file they are in" ) {
+			CHECK( pathWarnings.size() == streamWarnings.size() + 1 );
+			CHECK( pathWarnings.front() == missingQuoteWarning );
+			CHECK( pathWarnings.back().find("last unfinished") != std::string::npos );
+		}
+	}
+	GIVEN( "a file that is packed and unpacked" ) {
+		std::istringstream stream(text);
+		const DataFile original(stream);
+		std::string packed;
+		original.Pack(packed);
+		sink.Flush();
+
+		THEN( "it has the same nodes" ) {
+			DataFile unpacked;
+			REQUIRE( unpacked.Unpack(packed.data(), packed.data() + packed.size()) );
+			CHECK( Flatten(unpacked) == Flatten(original) );
+			CHECK( std::next(unpacked.begin()->begin())->Token(3) == "caf\xc3\xa9" );
+			CHECK( original.HasWarnings() );
+			CHECK_FALSE( unpacked.HasWarnings() );
+		}
+		THEN( "data that is cut short cannot be unpacked" ) {
+			DataFile unpacked;
+			CHECK_FALSE( unpacked.Unpack(packed.data(), packed.data() + packed.size() - 1) );
+			CHECK( unpacked.begin() == unpacked.end() );
+		}
+	}
+	GIVEN( "a file that does not exist" ) {
+		const DataFile root("test_datafile_missing.txt");
+		THEN( "it has no nodes" ) {
+			CHECK( root.begin() == root.end() );
+		}
+	}
+}
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark loading all of the game's data files", "[!benchmark][DataFile]" ) {
+	const std::vector<std::string> paths = DataFiles();
+	std::vector<std::string> texts;
+	for(const std::string &path : paths)
+		texts.push_back(Files::Read(path));
+
+	BENCHMARK( "Load " + std::to_string(paths.size()) + " files from their paths" ) {
+		std::size_t nodes = 0;
+		for(const std::string &path : paths)
+		{
+			const DataFile file(path);
+			nodes += std::distance(file.begin(), file.end());
+		}
+		return nodes;
+	};
+	BENCHMARK( "Load " + std::to_string(texts.size()) + " files that were already read" ) {
+		std::size_t nodes = 0;
+		for(const std::string &text : texts)
+		{
+			std::istringstream stream(text);
+			const DataFile file(stream);
+			nodes += std::distance(file.begin(), file.end());
+		}
+		return nodes;
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
@@ -18,9 +18,11 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 // Include only the tested class's header.
 #include "../../../source/DataNode.h"
 
-// Include a helper for creating well-formed DataNodes.
+// Include helpers for creating well-formed DataNodes, and for loading data files.
+#include "datafile-helpers.h"
 #include "datanode-factory.h"
 #include "output-capture.hpp"
+#include "../../../source/DataFile.h"
 
 // ... and any system includes needed for the test file.
 #include <string>
@@ -246,6 +248,62 @@ SCENARIO( "Determining if a token is numeric", "[IsNumber][Parsing][DataNode]" )
 	}
 }
 
+SCENARIO( "Converting the tokens of a DataNode to numbers", "[Value][Parsing][DataNode]" ) {
+	GIVEN( "A DataNode with numeric and non-numeric tokens" ) {
+		const std::vector<std::string> tokens = {"7", "-2.5", "+1e3", "25E-1", ".5", "0e400", "-", "monkey", "1.2.3",
+			"\"\""};
+		const DataNode node = AsDataNode("7 -2.5 +1e3 25E-1 .5 0e400 - monkey 1.2.3 \"\"");
+		REQUIRE( node.Size() == static_cast<int>(tokens.size()) );
+		THEN( "each token is a number only if the static check says so" ) {
+			for(int i = 0; i < node.Size() - 1; ++i)
+			{
+				CAPTURE( node.Token(i) );
+				CHECK( node.IsNumber(i) == DataNode::IsNumber(node.Token(i)) );
+			}
+			CHECK_FALSE( node.IsNumber(node.Size() - 1) );
+			CHECK_FALSE( node.IsNumber(node.Size()) );
+		}
+		THEN( "each number has the same value as the static conversion gives" ) {
+			for(int i = 0; i < 7; ++i)
+			{
+				CAPTURE( node.Token(i) );
+				CHECK( node.Value(i) == DataNode::Value(node.Token(i)) );
+			}
+			CHECK( node.Value(0) == 7. );
+			CHECK( node.Value(1) == -2.5 );
+			CHECK( node.Value(2) == 1000. );
+			CHECK( node.Value(3) == 2.5 );
+			CHECK( node.Value(4) == .5 );
+			CHECK( node.Value(5) == 0. );
+		}
+		WHEN( "the node is copied" ) {
+			DataNode copy(node);
+			DataNode assigned = AsDataNode("other 1");
+			assigned = node;
+			THEN( "the copies have the same values" ) {
+				for(int i = 0; i < node.Size(); ++i)
+				{
+					CHECK( copy.IsNumber(i) == node.IsNumber(i) );
+					CHECK( assigned.IsNumber(i) == node.IsNumber(i) );
+				}
+				CHECK( copy.Value(1) == -2.5 );
+				CHECK( assigned.Value(2) == 1000. );
+			}
+		}
+		WHEN( "the node is moved" ) {
+			DataNode copy(node);
+			DataNode moved(std::move(copy));
+			DataNode assigned = AsDataNode("other 1");
+			assigned = std::move(moved);
+			THEN( "the values are moved along with the tokens" ) {
+				REQUIRE( assigned.Size() == node.Size() );
+				CHECK( assigned.Value(3) == 2.5 );
+				CHECK_FALSE( assigned.IsNumber(7) );
+			}
+		}
+	}
+}
+
 SCENARIO( "Determining if a token is a boolean", "[Boolean][Parsing][DataNode]" ) {
 	GIVEN( "A string that is \"true\"/\"1\" or \"false\"/\"0\"" ) {
 		THEN( "IsBool returns true" ) {
@@ -284,6 +342,75 @@ SCENARIO( "Determining if a token is a boolean", "[Boolean][Parsing][DataNode]"
 }
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark DataNode number conversion", "[!benchmark][DataNode]" ) {
+	const DataNode node = AsDataNode("attributes 1 -2.5 300 4e3 monkey .5 \"not a number\" 123456.789");
+	BENCHMARK( "DataNode::IsNumber and DataNode::Value" ) {
+		double total = 0.;
+		for(int i = 0; i < node.Size(); ++i)
+			if(node.IsNumber(i))
+				total += node.Value(i);
+		return total;
+	};
+	// This is what every call to Value(int) used to cost.
+	BENCHMARK( "Static DataNode::IsNumber and DataNode::Value" ) {
+		double total = 0.;
+		for(const std::string &token : node.Tokens())
+			if(DataNode::IsNumber(token))
+				total += DataNode::Value(token);
+		return total;
+	};
+}
+
+// Add up every numeric token in the given node and its children, the way that
+// the objects' Load functions read them.
+double SumValues(const DataNode &node)
+{
+	double total = 0.;
+	for(int i = 0; i < node.Size(); ++i)
+		if(node.IsNumber(i))
+			total += node.Value(i);
+	for(const DataNode &child : node)
+		total += SumValues(child);
+	return total;
+}
+
+// Add them up by converting each token's text instead.
+double SumTokens(const DataNode &node)
+{
+	double total = 0.;
+	for(const std::string &token : node.Tokens())
+		if(DataNode::IsNumber(token))
+			total += DataNode::Value(token);
+	for(const DataNode &child : node)
+		total += SumTokens(child);
+	return total;
+}
+
+TEST_CASE( "Benchmark reading every number in the game's data files", "[!benchmark][DataNode]" ) {
+	std::vector<DataFile> files;
+	for(const std::string &path : DataFiles())
+		files.emplace_back(path);
+
+	BENCHMARK( "DataNode::IsNumber and DataNode::Value" ) {
+		double total = 0.;
+		for(const DataFile &file : files)
+			for(const DataNode &node : file)
+				total += SumValues(node);
+		return total;
+	};
+	BENCHMARK( "Static DataNode::IsNumber and DataNode::Value" ) {
+		double total = 0.;
+		for(const DataFile &file : files)
+			for(const DataNode &node : file)
+				total += SumTokens(node);
+		return total;
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
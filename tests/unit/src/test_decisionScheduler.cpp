@@ -0,0 +1,126 @@
+/* test_decisionScheduler.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/DecisionScheduler.h"
+
+// ... and any other headers needed to create ships.
+#include "../../../source/Point.h"
+#include "../../../source/Ship.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Use up the budget of the scheduler's current step, with decisions made by a
+// ship that is never told to wait.
+void UseBudget(DecisionScheduler &scheduler, const Ship &ship)
+{
+	for(int i = 0; i < 1000; ++i)
+		scheduler.Allow(ship, DecisionScheduler::FIND_TARGET);
+}
+
+// Ask for decisions for the given ships over several steps, and record which
+// ones were allowed.
+std::vector<bool> Schedule(const std::vector<Ship> &ships)
+{
+	DecisionScheduler scheduler;
+	std::vector<bool> allowed;
+	for(int step = 0; step < 20; ++step)
+	{
+		scheduler.BeginStep(nullptr, Point(100000., 0.));
+		for(const Ship &ship : ships)
+			allowed.push_back(scheduler.Allow(ship, DecisionScheduler::SELECT_ROUTE, step % 2));
+	}
+	return allowed;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Spreading decisions over several steps", "[DecisionScheduler]" ) {
+	GIVEN( "a scheduler, and ships far from the player" ) {
+		DecisionScheduler scheduler;
+		Ship first;
+		Ship second;
+		Ship yours;
+		yours.SetIsYours();
+		scheduler.BeginStep(nullptr, Point(100000., 0.));
+
+		THEN( "decisions are allowed while the step's budget lasts" ) {
+			CHECK( scheduler.Allow(first, DecisionScheduler::FIND_TARGET) );
+			CHECK( scheduler.Allow(second, DecisionScheduler::FIND_TARGET) );
+		}
+		WHEN( "the step's budget has been used up" ) {
+			UseBudget(scheduler, yours);
+			THEN( "only the player's ships may make decisions" ) {
+				CHECK_FALSE( scheduler.Allow(first, DecisionScheduler::FIND_TARGET) );
+				CHECK_FALSE( scheduler.Allow(second, DecisionScheduler::SELECT_ROUTE, true) );
+				CHECK( scheduler.Allow(yours, DecisionScheduler::FIND_TARGET) );
+			}
+			AND_WHEN( "the budget is used up in every step" ) {
+				int urgentWait = 0;
+				int wait = 0;
+				bool isUrgentAllowed = false;
+				bool isAllowed = false;
+				while(!isAllowed && wait < 100)
+				{
+					if(!isUrgentAllowed)
+						isUrgentAllowed = scheduler.Allow(second, DecisionScheduler::SELECT_ROUTE, true);
+					isAllowed = scheduler.Allow(first, DecisionScheduler::FIND_TARGET);
+					urgentWait += !isUrgentAllowed;
+					wait += !isAllowed;
+					scheduler.BeginStep(nullptr, Point(100000., 0.));
+					UseBudget(scheduler, yours);
+				}
+				THEN( "decisions are only put off for a limited time" ) {
+					CHECK( isUrgentAllowed );
+					CHECK( isAllowed );
+					CHECK( urgentWait < wait );
+					CHECK( wait < 100 );
+				}
+			}
+		}
+		WHEN( "the player is nearby" ) {
+			scheduler.BeginStep(nullptr, Point(100., 0.));
+			UseBudget(scheduler, yours);
+			THEN( "decisions are allowed even once the step's budget is used up" ) {
+				CHECK( scheduler.Allow(first, DecisionScheduler::FIND_TARGET) );
+			}
+		}
+	}
+	GIVEN( "more ships asking for decisions than the budget allows" ) {
+		const std::vector<Ship> ships(500);
+		WHEN( "the same ships ask for the same decisions twice" ) {
+			const std::vector<bool> first = Schedule(ships);
+			const std::vector<bool> second = Schedule(ships);
+			THEN( "the same decisions are allowed each time" ) {
+				CHECK( first == second );
+				CHECK( std::count(first.begin(), first.end(), false) > 0 );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
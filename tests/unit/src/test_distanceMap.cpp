@@ -0,0 +1,539 @@
+/* test_distanceMap.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/DistanceMap.h"
+#include "../../../source/DistanceTable.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include a helper for laying out test data.
+#include "scatter-helpers.h"
+
+// ... and any other headers needed to create a galaxy.
+#include "../../../source/DataFile.h"
+#include "../../../source/DataNode.h"
+#include "../../../source/ImageSet.h"
+#include "../../../source/Mask.h"
+#include "../../../source/Planet.h"
+#include "../../../source/Set.h"
+#include "../../../source/SpriteQueue.h"
+#include "../../../source/System.h"
+#include "../../../source/SystemGrid.h"
+#include "../../../source/Wormhole.h"
+
+// ... and any system includes needed for the test file.
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <queue>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// A square grid of systems 60 pixels apart, each linked to some of the
+// systems beside it, so that hyperspace routes wind around the grid but jump
+// drives can go straight across it.
+class Galaxy {
+public:
+	explicit Galaxy(int size)
+		: size(size)
+	{
+		for(int y = 0; y < size; ++y)
+			for(int x = 0; x < size; ++x)
+				Get(x, y)->Load(AsDataNode("system \"" + Name(x, y) + "\"\n\tpos "
+					+ std::to_string(60 * x) + " " + std::to_string(60 * y)), planets);
+		for(int y = 0; y < size; ++y)
+			for(int x = 0; x < size; ++x)
+			{
+				std::size_t hash = Hash(y * size + x);
+				if(x + 1 < size && hash % 3)
+					Get(x, y)->Link(Get(x + 1, y));
+				if(y + 1 < size && (hash / 3) % 4)
+					Get(x, y)->Link(Get(x, y + 1));
+			}
+		const SystemGrid grid(systems, System::DEFAULT_NEIGHBOR_DISTANCE);
+		for(auto &it : systems)
+			it.second.UpdateSystem(grid, {System::DEFAULT_NEIGHBOR_DISTANCE});
+	}
+
+	// Load the positions and hyperspace links of the systems in the given map
+	// file, without any of their other contents.
+	explicit Galaxy(const std::string &path)
+		: size(0)
+	{
+		const DataFile file(path);
+		std::vector<std::pair<System *, std::string>> links;
+		for(const DataNode &node : file)
+		{
+			if(node.Token(0) != "system" || node.Size() < 2)
+				continue;
+			System *system = systems.Get(node.Token(1));
+			for(const DataNode &child : node)
+			{
+				if(child.Token(0) == "pos" && child.Size() >= 3)
+					system->Load(AsDataNode("system `" + node.Token(1) + "`\n\tpos "
+						+ child.Token(1) + " " + child.Token(2)), planets);
+				else if(child.Token(0) == "link" && child.Size() >= 2)
+					links.emplace_back(system, child.Token(1));
+			}
+		}
+		for(const auto &it : links)
+			it.first->Link(systems.Get(it.second));
+		const SystemGrid grid(systems, System::DEFAULT_NEIGHBOR_DISTANCE);
+		for(auto &it : systems)
+			it.second.UpdateSystem(grid, {System::DEFAULT_NEIGHBOR_DISTANCE});
+	}
+
+	const System *At(int x, int y) { return Get(x, y); }
+
+	// Add a wormhole that leads from one system to another, and back only if
+	// both ends have a sprite. A restricted wormhole can only be used by ships
+	// that have a particular attribute.
+	void AddWormhole(const std::string &name, int fromX, int fromY, int toX, int toY, bool twoWay = false,
+		bool restricted = false)
+	{
+		const std::string sprite = "\n\t\tsprite planet/wormhole-red";
+		Planet *planet = planets.Get(name);
+		planet->Load(AsDataNode("planet `" + name + "`" + (restricted ? "\n\tattributes `requires: gaslining`" : "")),
+			wormholes);
+		Get(fromX, fromY)->Load(AsDataNode("system \"" + Name(fromX, fromY) + "\"\n\tadd object `" + name + "`"
+			+ sprite), planets);
+		Get(toX, toY)->Load(AsDataNode("system \"" + Name(toX, toY) + "\"\n\tadd object `" + name + "`"
+			+ (twoWay ? sprite : "")), planets);
+		planet->FinishLoading(wormholes);
+		for(auto &it : systems)
+			it.second.UpdateWormholeDistance(wormholes);
+	}
+
+	// Count the hyperspace jumps from the given system to every other system.
+	std::map<const System *, int> Hops(const System *center) const
+	{
+		std::map<const System *, int> hops;
+		std::queue<const System *> queue;
+		hops[center] = 0;
+		queue.push(center);
+		while(!queue.empty())
+		{
+			const System *system = queue.front();
+			queue.pop();
+			for(const System *link : system->Links())
+				if(hops.emplace(link, hops[system] + 1).second)
+					queue.push(link);
+		}
+		return hops;
+	}
+
+	Set<System> systems;
+	Set<Planet> planets;
+	Set<Wormhole> wormholes;
+	int size;
+
+private:
+	static std::string Name(int x, int y) { return "S " + std::to_string(x) + " " + std::to_string(y); }
+	System *Get(int x, int y) { return systems.Get(Name(x, y)); }
+};
+
+// Check that each system's route leads to a system that is one day closer,
+// along a path that the given function says is allowed.
+template <class Allowed>
+bool RoutesAreConsistent(const Galaxy &galaxy, const DistanceMap &map, const System *center, Allowed allowed)
+{
+	for(const auto &it : galaxy.systems)
+	{
+		const System *system = &it.second;
+		if(system == center || !map.HasRoute(system))
+			continue;
+		const System *next = map.Route(system);
+		if(!next || !allowed(system, next) || map.Days(next) != map.Days(system) - 1)
+			return false;
+	}
+	return true;
+}
+
+// Give a sprite its dimensions, without uploading it, so that the objects that
+// use it are treated as visible.
+void LoadSprite(const std::string &name, const std::string &path)
+{
+	auto images = std::make_shared<ImageSet>(name);
+	images->Add(path);
+	images->ValidateFrames();
+	SpriteQueue queue;
+	queue.PreventUpload();
+	queue.Add(images);
+	queue.Finish();
+}
+
+// Check that every distance in the table is what a DistanceMap would give.
+bool MatchesMaps(const Galaxy &galaxy, const DistanceTable &table, bool useJumpDrive,
+	WormholeStrategy wormholeStrategy = WormholeStrategy::NONE)
+{
+	for(const auto &from : galaxy.systems)
+	{
+		const DistanceMap map(&from.second, wormholeStrategy, useJumpDrive);
+		for(const auto &to : galaxy.systems)
+		{
+			int days = -2;
+			if(!table.Find(&from.second, &to.second, days) || days != map.Days(&to.second))
+				return false;
+		}
+	}
+	return true;
+}
+
+// Find routes between many pairs of systems both with and without an estimate
+// of the remaining distance, and check that both give equally good routes.
+// Count how many systems each search reached.
+bool EstimatesMatch(const Galaxy &galaxy, bool useJumpDrive, std::size_t &withEstimate, std::size_t &without,
+	WormholeStrategy wormholeStrategy = WormholeStrategy::NONE)
+{
+	std::vector<const System *> all;
+	for(const auto &it : galaxy.systems)
+		all.push_back(&it.second);
+
+	bool allMatch = true;
+	for(std::size_t i = 0; i < 200; ++i)
+	{
+		const System *source = all[Hash(i) % all.size()];
+		const System *destination = all[(i * 2246822519u + 7) % all.size()];
+		const DistanceMap guided(source, destination, wormholeStrategy, useJumpDrive);
+		const DistanceMap plain(source, destination, wormholeStrategy, useJumpDrive, false);
+		allMatch &= (guided.Days(source) == plain.Days(source));
+		allMatch &= (guided.RequiredFuel(source, destination) == plain.RequiredFuel(source, destination));
+		withEstimate += guided.Systems().size();
+		without += plain.Systems().size();
+
+		// The route must actually lead from the source to the destination.
+		if(guided.HasRoute(source))
+		{
+			int days = 0;
+			for(const System *system = source; system != destination; system = guided.Route(system))
+				allMatch &= (system && ++days <= guided.Days(source));
+		}
+	}
+	return allMatch;
+}
+
+// Check that searches from every system to the given destination find equally
+// good routes with and without an estimate of the remaining distance.
+bool EstimatesMatch(const Galaxy &galaxy, const System *destination, WormholeStrategy wormholeStrategy)
+{
+	bool allMatch = true;
+	for(const auto &it : galaxy.systems)
+	{
+		const System *source = &it.second;
+		const DistanceMap guided(source, destination, wormholeStrategy, false);
+		const DistanceMap plain(source, destination, wormholeStrategy, false, false);
+		allMatch &= (guided.Days(source) == plain.Days(source));
+	}
+	return allMatch;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Numbering systems", "[System]" ) {
+	GIVEN( "a galaxy" ) {
+		Galaxy galaxy(5);
+		THEN( "each system has its own index" ) {
+			std::set<unsigned> indices;
+			for(const auto &it : galaxy.systems)
+				indices.insert(it.second.Index());
+			CHECK( static_cast<int>(indices.size()) == galaxy.systems.size() );
+		}
+		THEN( "a copy of a system has the same index" ) {
+			const System *system = galaxy.At(2, 3);
+			System copy = *system;
+			CHECK( copy.Index() == system->Index() );
+		}
+	}
+}
+
+SCENARIO( "Finding the distances to other systems", "[DistanceMap]" ) {
+	GIVEN( "a galaxy with winding hyperspace links" ) {
+		Galaxy galaxy(12);
+		const System *center = galaxy.At(5, 6);
+		const std::map<const System *, int> hops = galaxy.Hops(center);
+		auto isLink = [](const System *from, const System *to) -> bool { return from->Links().count(to); };
+
+		WHEN( "a map is made using only hyperspace links" ) {
+			const DistanceMap map(center);
+			THEN( "the distance to each system is the number of jumps to it" ) {
+				bool allMatch = true;
+				for(const auto &it : galaxy.systems)
+				{
+					auto hit = hops.find(&it.second);
+					int expected = (hit == hops.end() ? -1 : hit->second);
+					allMatch &= (map.Days(&it.second) == expected);
+					allMatch &= (map.HasRoute(&it.second) == (expected >= 0));
+				}
+				CHECK( allMatch );
+				CHECK( map.Systems().size() == hops.size() );
+				CHECK( map.Days(center) == 0 );
+				CHECK( map.Days(nullptr) == -1 );
+			}
+			THEN( "each route follows a link to a closer system" ) {
+				CHECK( RoutesAreConsistent(galaxy, map, center, isLink) );
+				CHECK( map.Route(center) == nullptr );
+			}
+		}
+		WHEN( "a map is limited to a maximum distance" ) {
+			const DistanceMap map(center, -1, 3);
+			THEN( "only the systems within that distance are included" ) {
+				bool allMatch = true;
+				for(const auto &it : galaxy.systems)
+				{
+					auto hit = hops.find(&it.second);
+					bool expected = (hit != hops.end() && hit->second <= 3);
+					allMatch &= (map.HasRoute(&it.second) == expected);
+					if(expected)
+						allMatch &= (map.Days(&it.second) == hit->second);
+				}
+				CHECK( allMatch );
+			}
+		}
+		WHEN( "a map is made using a jump drive" ) {
+			const DistanceMap map(center, WormholeStrategy::NONE, true);
+			THEN( "every system can be reached, and no sooner than it could be with links alone" ) {
+				bool allMatch = true;
+				for(const auto &it : galaxy.systems)
+				{
+					allMatch &= map.HasRoute(&it.second);
+					auto hit = hops.find(&it.second);
+					if(hit != hops.end())
+						allMatch &= (map.RequiredFuel(center, &it.second) <= 100 * hit->second);
+				}
+				CHECK( allMatch );
+			}
+			THEN( "each route leads to a closer system that can be jumped to" ) {
+				auto canJump = [](const System *from, const System *to) -> bool
+				{
+					return from->JumpNeighbors(System::DEFAULT_NEIGHBOR_DISTANCE).count(to);
+				};
+				CHECK( RoutesAreConsistent(galaxy, map, center, canJump) );
+			}
+		}
+		WHEN( "a map is copied" ) {
+			DistanceMap map(galaxy.At(0, 0));
+			map = DistanceMap(center);
+			THEN( "the copy gives the same answers" ) {
+				CHECK( map.Days(galaxy.At(5, 7)) == hops.at(galaxy.At(5, 7)) );
+				CHECK( RoutesAreConsistent(galaxy, map, center, isLink) );
+			}
+		}
+	}
+}
+
+SCENARIO( "Finding a route between two systems", "[DistanceMap]" ) {
+	Galaxy galaxy(20);
+	GIVEN( "routes that use only hyperspace links" ) {
+		std::size_t withEstimate = 0;
+		std::size_t without = 0;
+		THEN( "searching toward the source finds equally good routes while reaching fewer systems" ) {
+			CHECK( EstimatesMatch(galaxy, false, withEstimate, without) );
+			CHECK( withEstimate < without );
+		}
+	}
+	GIVEN( "routes that use a jump drive" ) {
+		std::size_t withEstimate = 0;
+		std::size_t without = 0;
+		THEN( "searching toward the source finds equally good routes while reaching fewer systems" ) {
+			CHECK( EstimatesMatch(galaxy, true, withEstimate, without) );
+			CHECK( withEstimate < without );
+		}
+	}
+	GIVEN( "routes that may use wormholes, some of which lead only one way or are restricted" ) {
+		LoadSprite("planet/wormhole-red", "../images/planet/wormhole-red.png");
+		galaxy.AddWormhole("One Way", 1, 1, 18, 17);
+		galaxy.AddWormhole("Shortcut", 10, 4, 9, 15, true);
+		galaxy.AddWormhole("Restricted", 18, 1, 2, 18, true, true);
+		std::size_t withEstimate = 0;
+		std::size_t without = 0;
+		THEN( "a one-way wormhole only shortens the way in the direction it leads" ) {
+			const DistanceMap there(galaxy.At(1, 1), WormholeStrategy::ONLY_UNRESTRICTED, false);
+			const DistanceMap back(galaxy.At(18, 17), WormholeStrategy::ONLY_UNRESTRICTED, false);
+			CHECK( there.Days(galaxy.At(18, 17)) == 1 );
+			CHECK( back.Days(galaxy.At(1, 1)) > 1 );
+		}
+		WHEN( "only unrestricted wormholes are used" ) {
+			THEN( "searching toward the source finds equally good routes" ) {
+				CHECK( EstimatesMatch(galaxy, false, withEstimate, without, WormholeStrategy::ONLY_UNRESTRICTED) );
+				CHECK( EstimatesMatch(galaxy, true, withEstimate, without, WormholeStrategy::ONLY_UNRESTRICTED) );
+				CHECK( EstimatesMatch(galaxy, galaxy.At(9, 15), WormholeStrategy::ONLY_UNRESTRICTED) );
+			}
+			THEN( "the unrestricted wormhole is used" ) {
+				const DistanceMap map(galaxy.At(10, 4), galaxy.At(9, 15), WormholeStrategy::ONLY_UNRESTRICTED, false);
+				CHECK( map.Days(galaxy.At(10, 4)) == 1 );
+			}
+			THEN( "the restricted wormhole is not used" ) {
+				const DistanceMap map(galaxy.At(18, 1), galaxy.At(2, 18), WormholeStrategy::ONLY_UNRESTRICTED, false);
+				CHECK( map.Days(galaxy.At(18, 1)) > 1 );
+			}
+		}
+		WHEN( "all wormholes are used" ) {
+			THEN( "searching toward the source finds equally good routes" ) {
+				CHECK( EstimatesMatch(galaxy, false, withEstimate, without, WormholeStrategy::ALL) );
+				CHECK( EstimatesMatch(galaxy, true, withEstimate, without, WormholeStrategy::ALL) );
+				CHECK( EstimatesMatch(galaxy, galaxy.At(2, 18), WormholeStrategy::ALL) );
+			}
+			THEN( "the restricted wormhole is used" ) {
+				const DistanceMap map(galaxy.At(18, 1), galaxy.At(2, 18), WormholeStrategy::ALL, false);
+				CHECK( map.Days(galaxy.At(18, 1)) == 1 );
+			}
+		}
+	}
+	GIVEN( "a source and destination that are the same" ) {
+		const DistanceMap map(galaxy.At(3, 3), galaxy.At(3, 3), WormholeStrategy::NONE, false);
+		THEN( "the route takes no time" ) {
+			CHECK( map.Days(galaxy.At(3, 3)) == 0 );
+		}
+	}
+}
+
+SCENARIO( "Looking up distances in a table", "[DistanceTable]" ) {
+	Galaxy galaxy(10);
+	GIVEN( "a table for hyperspace travel" ) {
+		DistanceTable table(galaxy.systems, WormholeStrategy::NONE, false);
+		WHEN( "the table has not been built" ) {
+			THEN( "it has no answers" ) {
+				int days = -1;
+				CHECK_FALSE( table.Find(galaxy.At(0, 0), galaxy.At(1, 0), days) );
+			}
+		}
+		WHEN( "the table is built" ) {
+			table.Build();
+			THEN( "every distance is the same as in a map centered on the first system" ) {
+				CHECK( MatchesMaps(galaxy, table, false) );
+			}
+			THEN( "systems that are not in the table have no answers" ) {
+				System other;
+				int days = -1;
+				CHECK_FALSE( table.Find(&other, galaxy.At(0, 0), days) );
+				CHECK_FALSE( table.Find(galaxy.At(0, 0), nullptr, days) );
+			}
+		}
+	}
+	GIVEN( "a table for jump drive travel" ) {
+		DistanceTable table(galaxy.systems, WormholeStrategy::NONE, true);
+		WHEN( "the table is built" ) {
+			table.Build();
+			THEN( "every distance is the same as in a map centered on the first system" ) {
+				CHECK( MatchesMaps(galaxy, table, true) );
+			}
+		}
+	}
+	GIVEN( "a galaxy with a one-way wormhole to a faraway system" ) {
+		// Lead the wormhole from a corner of the grid to the system that takes
+		// the most jumps to reach from there.
+		const System *source = galaxy.At(9, 9);
+		const std::map<const System *, int> hops = galaxy.Hops(source);
+		int farX = 9;
+		int farY = 9;
+		for(int y = 0; y < galaxy.size; ++y)
+			for(int x = 0; x < galaxy.size; ++x)
+				if(hops.count(galaxy.At(x, y)) && hops.at(galaxy.At(x, y)) > hops.at(galaxy.At(farX, farY)))
+				{
+					farX = x;
+					farY = y;
+				}
+		const System *far = galaxy.At(farX, farY);
+		REQUIRE( hops.at(far) > 2 );
+		LoadSprite("planet/wormhole-red", "../images/planet/wormhole-red.png");
+		galaxy.AddWormhole("Wormhole", 9, 9, farX, farY);
+		WHEN( "a table is built that uses wormholes" ) {
+			DistanceTable table(galaxy.systems, WormholeStrategy::ONLY_UNRESTRICTED, false);
+			table.Build();
+			THEN( "the wormhole only shortens the way in the direction it leads" ) {
+				int there = -1;
+				int back = -1;
+				REQUIRE( table.Find(source, far, there) );
+				REQUIRE( table.Find(far, source, back) );
+				CHECK( there == 1 );
+				CHECK( back == hops.at(far) );
+			}
+			THEN( "every distance is the same as in a map centered on the first system" ) {
+				CHECK( MatchesMaps(galaxy, table, false, WormholeStrategy::ONLY_UNRESTRICTED) );
+			}
+		}
+		WHEN( "a table is built that does not use wormholes" ) {
+			DistanceTable table(galaxy.systems, WormholeStrategy::NONE, false);
+			table.Build();
+			THEN( "the wormhole is ignored" ) {
+				int there = -1;
+				REQUIRE( table.Find(source, far, there) );
+				CHECK( there == hops.at(far) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+// Find routes between many pairs of systems, and count how many systems the
+// searches reached in total.
+std::size_t FindRoutes(const Galaxy &galaxy, bool useJumpDrive, bool useEstimate)
+{
+	std::vector<const System *> all;
+	for(const auto &it : galaxy.systems)
+		all.push_back(&it.second);
+
+	std::size_t reached = 0;
+	for(std::size_t i = 0; i < 200; ++i)
+	{
+		const System *source = all[Hash(i) % all.size()];
+		const System *destination = all[(i * 2246822519u + 7) % all.size()];
+		reached += DistanceMap(source, destination, WormholeStrategy::NONE, useJumpDrive, useEstimate).Systems().size();
+	}
+	return reached;
+}
+
+TEST_CASE( "Benchmark DistanceMap routes between two systems", "[!benchmark][DistanceMap]" ) {
+	Galaxy synthetic(100);
+	Galaxy shipped("../data/map systems.txt");
+	for(const Galaxy *galaxy : {&synthetic, &shipped})
+	{
+		if(galaxy->systems.size() < 2)
+			continue;
+		for(bool useJumpDrive : {false, true})
+		{
+			const std::string kind = std::to_string(galaxy->systems.size()) + " systems, "
+				+ (useJumpDrive ? "jump drive" : "hyperdrive");
+			WARN( kind + ": 200 routes reached " + std::to_string(FindRoutes(*galaxy, useJumpDrive, true))
+				+ " systems with an estimate and " + std::to_string(FindRoutes(*galaxy, useJumpDrive, false))
+				+ " without" );
+
+			BENCHMARK( "200 routes with an estimate, " + kind ) {
+				return FindRoutes(*galaxy, useJumpDrive, true);
+			};
+			BENCHMARK( "200 routes without an estimate, " + kind ) {
+				return FindRoutes(*galaxy, useJumpDrive, false);
+			};
+		}
+	}
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,139 @@
+/* test_firingCache.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/FiringCache.h"
+
+// ... and any other headers needed to create targets.
+#include "../../../source/Angle.h"
+#include "../../../source/Body.h"
+#include "../../../source/ImageBuffer.h"
+#include "../../../source/Mask.h"
+#include "../../../source/Point.h"
+#include "../../../source/Sprite.h"
+
+namespace { // test namespace
+
+// #region mock data
+// A target that can be turned.
+class TestBody : public Body {
+public:
+	TestBody(const Sprite *sprite, Point position) : Body(sprite, position) {}
+
+	void Turn(double degrees) { angle += degrees; }
+};
+
+// A sprite with dimensions but no image data.
+const Sprite *GetSprite()
+{
+	static Sprite sprite;
+	if(!sprite.Width())
+	{
+		ImageBuffer buffer;
+		buffer.Allocate(40, 40);
+		sprite.AddFrames(buffer, false, false);
+	}
+	return &sprite;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Reusing recent firing solutions", "[FiringCache]" ) {
+	GIVEN( "a cache with one solution stored" ) {
+		TestBody target(GetSprite(), Point(500., 0.));
+		Mask mask;
+		Mask otherMask;
+		const Point p(500., 0.);
+		const Point v(-800., 10.);
+		FiringCache cache;
+		cache.BeginStep();
+		cache.Store(2, target, mask, p, v, true);
+		bool hits = false;
+
+		THEN( "the same query is answered" ) {
+			CHECK( cache.Find(2, target, mask, p, v, hits) );
+			CHECK( hits );
+		}
+		THEN( "other weapons and targets are not answered" ) {
+			TestBody other(GetSprite(), Point(500., 0.));
+			CHECK_FALSE( cache.Find(1, target, mask, p, v, hits) );
+			CHECK_FALSE( cache.Find(3, target, mask, p, v, hits) );
+			CHECK_FALSE( cache.Find(2, other, mask, p, v, hits) );
+		}
+		THEN( "a query whose path has moved slightly is answered" ) {
+			CHECK( cache.Find(2, target, mask, p + Point(1., 1.), v, hits) );
+			CHECK( cache.Find(2, target, mask, p, v + Point(0., 1.5), hits) );
+		}
+		THEN( "a query whose path has moved further is not answered" ) {
+			CHECK_FALSE( cache.Find(2, target, mask, p + Point(3., 0.), v, hits) );
+			CHECK_FALSE( cache.Find(2, target, mask, p, v + Point(0., 3.), hits) );
+		}
+		THEN( "a query for a different animation frame is not answered" ) {
+			CHECK_FALSE( cache.Find(2, target, otherMask, p, v, hits) );
+		}
+		WHEN( "the target turns" ) {
+			target.Turn(10.);
+			THEN( "the solution is not used" ) {
+				CHECK_FALSE( cache.Find(2, target, mask, p, v, hits) );
+			}
+		}
+		WHEN( "a few steps pass" ) {
+			for(int i = 0; i < 3; ++i)
+				cache.BeginStep();
+			THEN( "the solution is still used" ) {
+				CHECK( cache.Find(2, target, mask, p, v, hits) );
+			}
+			AND_WHEN( "another step passes" ) {
+				cache.BeginStep();
+				THEN( "the solution is too old to use" ) {
+					CHECK_FALSE( cache.Find(2, target, mask, p, v, hits) );
+				}
+			}
+		}
+		WHEN( "a new solution is stored for the same weapon and target" ) {
+			cache.Store(2, target, mask, p + Point(10., 0.), v, false);
+			THEN( "it replaces the old one" ) {
+				CHECK_FALSE( cache.Find(2, target, mask, p, v, hits) );
+				CHECK( cache.Find(2, target, mask, p + Point(10., 0.), v, hits) );
+				CHECK_FALSE( hits );
+			}
+		}
+		WHEN( "queries are made" ) {
+			cache.Find(2, target, mask, p, v, hits);
+			cache.Find(2, target, mask, p + Point(5., 0.), v, hits);
+			cache.Find(0, target, mask, p, v, hits);
+			THEN( "the queries and the answers are counted" ) {
+				CHECK( cache.Lookups() == 3 );
+				CHECK( cache.Hits() == 1 );
+			}
+			AND_WHEN( "the counts are reset" ) {
+				cache.ResetCounts();
+				THEN( "they are zero" ) {
+					CHECK( cache.Lookups() == 0 );
+					CHECK( cache.Hits() == 0 );
+				}
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
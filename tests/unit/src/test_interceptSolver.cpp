@@ -0,0 +1,138 @@
+/* test_interceptSolver.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/InterceptSolver.h"
+
+// Include a helper for laying out test data.
+#include "scatter-helpers.h"
+
+// ... and any other headers needed to create problems.
+#include "../../../source/Point.h"
+
+// ... and any system includes needed for the test file.
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// A batch of problems, including targets that cannot be reached, targets that
+// are exactly as fast as the projectile, and targets at the firing point.
+InterceptSolver MakeProblems(std::size_t count)
+{
+	InterceptSolver solver;
+	solver.Clear(count);
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		Point p(1000. * Scatter(i, 1), 1000. * Scatter(i, 2));
+		Point v(20. * Scatter(i, 3), 20. * Scatter(i, 4));
+		double vp = 15. * (Scatter(i, 5) + 1.);
+		if(i % 7 == 3)
+			vp = v.Length();
+		if(i % 11 == 5)
+			p = Point();
+		solver.Add(p, v, vp);
+	}
+	return solver;
+}
+
+bool IsSame(double a, double b)
+{
+	return (std::isnan(a) && std::isnan(b)) || !std::memcmp(&a, &b, sizeof(double));
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding how long projectiles take to reach their targets", "[InterceptSolver]" ) {
+	GIVEN( "a single problem" ) {
+		THEN( "a stationary target is reached at the projectile's speed" ) {
+			CHECK( InterceptSolver::Time(Point(100., 0.), Point(), 10.) == Approx(10.) );
+		}
+		THEN( "a target that is faster than the projectile and moving away is never reached" ) {
+			CHECK( std::isnan(InterceptSolver::Time(Point(100., 0.), Point(20., 0.), 10.)) );
+		}
+	}
+	GIVEN( "a batch of problems" ) {
+		InterceptSolver solver = MakeProblems(1001);
+		REQUIRE( solver.Size() == 1001 );
+		WHEN( "the batch is solved" ) {
+			solver.Solve();
+			THEN( "each solution is exactly the same as solving that problem alone" ) {
+				bool allMatch = true;
+				bool allStored = true;
+				std::size_t reached = 0;
+				for(std::size_t i = 0; i < solver.Size(); ++i)
+				{
+					Point p(1000. * Scatter(i, 1), 1000. * Scatter(i, 2));
+					Point v(20. * Scatter(i, 3), 20. * Scatter(i, 4));
+					double vp = 15. * (Scatter(i, 5) + 1.);
+					if(i % 7 == 3)
+						vp = v.Length();
+					if(i % 11 == 5)
+						p = Point();
+					allMatch &= IsSame(solver.Time(i), InterceptSolver::Time(p, v, vp));
+					allStored &= (solver.Position(i).X() == p.X() && solver.Position(i).Y() == p.Y()
+						&& solver.Velocity(i).X() == v.X() && solver.Velocity(i).Y() == v.Y() && solver.Speed(i) == vp);
+					reached += !std::isnan(solver.Time(i));
+				}
+				CHECK( allMatch );
+				CHECK( allStored );
+				// Make sure that both kinds of result were checked.
+				CHECK( reached > 100 );
+				CHECK( reached < solver.Size() - 100 );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark InterceptSolver", "[!benchmark][InterceptSolver]" ) {
+	InterceptSolver solver = MakeProblems(1000);
+	std::vector<Point> positions;
+	std::vector<Point> velocities;
+	std::vector<double> speeds;
+	for(std::size_t i = 0; i < 1000; ++i)
+	{
+		positions.emplace_back(1000. * Scatter(i, 1), 1000. * Scatter(i, 2));
+		velocities.emplace_back(20. * Scatter(i, 3), 20. * Scatter(i, 4));
+		speeds.push_back(15. * (Scatter(i, 5) + 1.));
+	}
+
+	BENCHMARK( "InterceptSolver::Time, once per problem" ) {
+		double total = 0.;
+		for(std::size_t i = 0; i < positions.size(); ++i)
+			total += InterceptSolver::Time(positions[i], velocities[i], speeds[i]);
+		return total;
+	};
+	BENCHMARK( "InterceptSolver::Solve" ) {
+		solver.Solve();
+		return solver.Time(0);
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,261 @@
+/* test_mask.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/Mask.h"
+
+// Include a helper for laying out test data.
+#include "scatter-helpers.h"
+
+// ... and any other headers needed to create masks.
+#include "../../../source/Angle.h"
+#include "../../../source/ImageBuffer.h"
+#include "../../../source/Point.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Create a mask from an image of a ring with a jagged outer edge and a round
+// hole, plus a separate blob, so that it has several outlines and many edges.
+Mask MakeMask()
+{
+	const int size = 256;
+	ImageBuffer buffer;
+	buffer.Allocate(size, size);
+	for(int y = 0; y < size; ++y)
+		for(int x = 0; x < size; ++x)
+		{
+			Point p(x - 100., y - 128.);
+			double angle = std::atan2(p.Y(), p.X());
+			double outer = 80. + 12. * std::sin(7. * angle) + 5. * std::cos(19. * angle);
+			bool isRing = (p.Length() < outer && p.Length() > 30.);
+			bool isBlob = (Point(x - 215., y - 200.).Length() < 25.);
+			buffer.Begin(y)[x] = (isRing || isBlob) ? 0xFFFFFFFFu : 0u;
+		}
+	Mask mask;
+	mask.Create(buffer);
+	return mask;
+}
+
+// Straightforward versions of the mask's queries, which examine every edge.
+double BruteIntersection(const Mask &mask, Point sA, Point vA, Angle facing)
+{
+	sA = (-facing).Rotate(sA);
+	vA = (-facing).Rotate(vA);
+	double closest = 1.;
+	for(const auto &outline : mask.Outlines())
+	{
+		Point prev = outline.back();
+		for(const Point &next : outline)
+		{
+			Point vB = next - prev;
+			double cross = vB.Cross(vA);
+			if(cross > 0.)
+			{
+				Point vS = prev - sA;
+				double uB = vA.Cross(vS);
+				double uA = vB.Cross(vS);
+				if((uB >= 0.) & (uB < cross) & (uA >= 0.))
+					closest = std::min(closest, uA / cross);
+			}
+			prev = next;
+		}
+	}
+	return closest;
+}
+
+bool BruteContains(const Mask &mask, Point point, Angle facing)
+{
+	point = (-facing).Rotate(point);
+	int intersections = 0;
+	for(const auto &outline : mask.Outlines())
+	{
+		Point prev = outline.back();
+		for(const Point &next : outline)
+		{
+			if(prev.X() != next.X())
+				if((prev.X() <= point.X()) == (point.X() < next.X()))
+				{
+					double y = prev.Y() + (next.Y() - prev.Y()) *
+						(point.X() - prev.X()) / (next.X() - prev.X());
+					intersections += (y >= point.Y());
+				}
+			prev = next;
+		}
+	}
+	return intersections & 1;
+}
+
+bool BruteWithinRing(const Mask &mask, Point point, Angle facing, double inner, double outer)
+{
+	point = (-facing).Rotate(point);
+	for(const auto &outline : mask.Outlines())
+		for(const Point &p : outline)
+		{
+			double pSquared = p.DistanceSquared(point);
+			if(pSquared < outer * outer && pSquared > inner * inner)
+				return true;
+		}
+	return false;
+}
+
+double BruteRange(const Mask &mask, Point point, Angle facing)
+{
+	if(BruteContains(mask, point, facing))
+		return 0.;
+	point = (-facing).Rotate(point);
+	double range = std::numeric_limits<double>::infinity();
+	for(const auto &outline : mask.Outlines())
+		for(const Point &p : outline)
+			range = std::min(range, p.Distance(point));
+	return range;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Testing segments and points against a mask", "[Mask]" ) {
+	GIVEN( "a mask with several outlines" ) {
+		const Mask mask = MakeMask();
+		REQUIRE( mask.IsLoaded() );
+		REQUIRE( mask.Outlines().size() >= 3 );
+
+		WHEN( "segments are checked for collisions" ) {
+			bool allMatch = true;
+			std::size_t hits = 0;
+			for(std::size_t i = 0; i < 5000; ++i)
+			{
+				Point sA(150. * Scatter(i, 1), 150. * Scatter(i, 2));
+				Point vA(200. * Scatter(i, 3), 200. * Scatter(i, 4));
+				Angle facing(360. * Scatter(i, 5));
+				double range = mask.Collide(sA, vA, facing);
+				double expected = (sA.Length() <= mask.Radius() && BruteContains(mask, sA, facing))
+					? 0. : BruteIntersection(mask, sA, vA, facing);
+				allMatch &= (range == expected);
+				hits += (range < 1.);
+			}
+			THEN( "the results are the same as checking every edge" ) {
+				CHECK( allMatch );
+				CHECK( hits > 100 );
+			}
+		}
+		WHEN( "points are checked" ) {
+			bool containsMatch = true;
+			bool ringMatch = true;
+			bool rangeMatch = true;
+			for(std::size_t i = 0; i < 5000; ++i)
+			{
+				Point point(150. * Scatter(i, 6), 150. * Scatter(i, 7));
+				Angle facing(360. * Scatter(i, 8));
+				double inner = 60. * (Scatter(i, 9) + 1.);
+				double outer = inner + 40. * (Scatter(i, 10) + 1.);
+				bool expectedContains = (point.Length() <= mask.Radius() && BruteContains(mask, point, facing));
+				containsMatch &= (mask.Contains(point, facing) == expectedContains);
+				if(inner <= point.Length() + mask.Radius() && outer >= point.Length() - mask.Radius())
+					ringMatch &= (mask.WithinRing(point, facing, inner, outer)
+						== BruteWithinRing(mask, point, facing, inner, outer));
+				rangeMatch &= (mask.Range(point, facing) == BruteRange(mask, point, facing));
+			}
+			THEN( "the results are the same as checking every edge" ) {
+				CHECK( containsMatch );
+				CHECK( ringMatch );
+				CHECK( rangeMatch );
+			}
+		}
+		WHEN( "the mask is scaled" ) {
+			const Mask scaled = mask * .5;
+			bool allMatch = true;
+			for(std::size_t i = 0; i < 1000; ++i)
+			{
+				Point point(75. * Scatter(i, 11), 75. * Scatter(i, 12));
+				allMatch &= (scaled.Range(point, Angle()) == BruteRange(scaled, point, Angle()));
+			}
+			THEN( "the scaled mask gives the same results as checking every edge" ) {
+				CHECK( scaled.Radius() == mask.Radius() * .5 );
+				CHECK( allMatch );
+			}
+		}
+		WHEN( "several masks are combined into one buffer" ) {
+			std::vector<Mask> masks(3, mask);
+			masks[1] = Mask();
+			const std::vector<Mask> combined = Mask::Combine(masks, 2.);
+			bool allMatch = true;
+			for(std::size_t i = 0; i < 1000; ++i)
+			{
+				Point point(300. * Scatter(i, 13), 300. * Scatter(i, 14));
+				Angle facing(360. * Scatter(i, 15));
+				allMatch &= (combined[2].Range(point, facing) == BruteRange(combined[2], point, facing));
+				allMatch &= (combined[0].Contains(point, facing) == (mask * 2.).Contains(point, facing));
+			}
+			THEN( "each combined mask gives the same results as a separate one" ) {
+				REQUIRE( combined.size() == 3 );
+				CHECK( combined[0].IsLoaded() );
+				CHECK( !combined[1].IsLoaded() );
+				CHECK( combined[2].Outlines().size() == mask.Outlines().size() );
+				CHECK( combined[2].Radius() == mask.Radius() * 2. );
+				CHECK( allMatch );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Mask queries", "[!benchmark][Mask]" ) {
+	const Mask mask = MakeMask();
+	std::vector<Point> starts;
+	std::vector<Point> vectors;
+	for(std::size_t i = 0; i < 1000; ++i)
+	{
+		starts.emplace_back(120. * Scatter(i, 1), 120. * Scatter(i, 2));
+		vectors.emplace_back(40. * Scatter(i, 3), 40. * Scatter(i, 4));
+	}
+
+	BENCHMARK( "Mask::Collide" ) {
+		double total = 0.;
+		for(std::size_t i = 0; i < starts.size(); ++i)
+			total += mask.Collide(starts[i], vectors[i], Angle());
+		return total;
+	};
+	BENCHMARK( "Mask::Contains" ) {
+		int total = 0;
+		for(const Point &point : starts)
+			total += mask.Contains(point, Angle());
+		return total;
+	};
+	BENCHMARK( "Mask::Range" ) {
+		double total = 0.;
+		for(const Point &point : starts)
+			total += mask.Range(point, Angle());
+		return total;
+	};
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
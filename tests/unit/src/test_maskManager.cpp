@@ -0,0 +1,102 @@
+/* test_maskManager.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/MaskManager.h"
+
+// ... and any other headers needed to create masks.
+#include "../../../source/ImageBuffer.h"
+#include "../../../source/Mask.h"
+#include "../../../source/Sprite.h"
+
+// ... and any system includes needed for the test file.
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Create the masks for a sprite with one frame, which is a square of the given
+// size in the middle of the image.
+std::vector<Mask> MakeMasks(int size)
+{
+	ImageBuffer buffer;
+	buffer.Allocate(64, 64);
+	for(int y = 0; y < 64; ++y)
+		for(int x = 0; x < 64; ++x)
+		{
+			bool isInside = (x >= 32 - size / 2 && x < 32 + size / 2 && y >= 32 - size / 2 && y < 32 + size / 2);
+			buffer.Begin(y)[x] = isInside ? 0xFFFFFFFFu : 0u;
+		}
+	std::vector<Mask> masks(1);
+	masks.front().Create(buffer);
+	return masks;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Giving a sprite new masks", "[MaskManager]" ) {
+	MaskManager manager;
+	const Sprite sprite("test sprite");
+	manager.RegisterScale(&sprite, 2.);
+	manager.SetMasks(&sprite, MakeMasks(20));
+	manager.UpdateMasks();
+
+	GIVEN( "masks that are in use" ) {
+		const std::vector<Mask> &base = manager.GetMasks(&sprite, 1.);
+		const std::vector<Mask> &scaled = manager.GetMasks(&sprite, 2.);
+		REQUIRE( base.size() == 1 );
+		REQUIRE( scaled.size() == 1 );
+		const double radius = base.front().Radius();
+		CHECK( scaled.front().Radius() == Approx(2. * radius) );
+
+		WHEN( "new masks are given" ) {
+			manager.SetMasks(&sprite, MakeMasks(40));
+			THEN( "the masks in use do not change" ) {
+				CHECK( &manager.GetMasks(&sprite, 1.) == &base );
+				REQUIRE( base.size() == 1 );
+				CHECK( base.front().Radius() == radius );
+				REQUIRE( scaled.size() == 1 );
+				CHECK( scaled.front().Radius() == Approx(2. * radius) );
+			}
+			AND_WHEN( "the masks are updated" ) {
+				manager.UpdateMasks();
+				THEN( "the new masks are used at every scale" ) {
+					const std::vector<Mask> &newBase = manager.GetMasks(&sprite, 1.);
+					const std::vector<Mask> &newScaled = manager.GetMasks(&sprite, 2.);
+					REQUIRE( newBase.size() == 1 );
+					REQUIRE( newScaled.size() == 1 );
+					CHECK( newBase.front().Radius() > radius );
+					CHECK( newScaled.front().Radius() == Approx(2. * newBase.front().Radius()) );
+				}
+			}
+		}
+	}
+	GIVEN( "a sprite whose masks have not been updated yet" ) {
+		const Sprite other("other sprite");
+		manager.SetMasks(&other, MakeMasks(20));
+		THEN( "it has no masks" ) {
+			CHECK( manager.GetMasks(&other, 1.).empty() );
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -19,7 +19,10 @@ this program. If not, see <https://www.gnu.org/licenses/>.
 #include "../../../source/Set.h"
 
 // ... and any system includes needed for the test file.
+#include <map>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace { // test namespace
 // #region mock data
@@ -27,6 +30,15 @@ class T {
 public:
 	int a = 1;
 };
+
+// Names like those of the outfits in the game data, which often share long prefixes.
+std::vector<std::string> MakeNames(int count)
+{
+	std::vector<std::string> names;
+	for(int i = 0; i < count; ++i)
+		names.push_back("Outfit Class " + std::to_string(i % 7) + " Mark " + std::to_string(i));
+	return names;
+}
 // #endregion mock data
 
 
@@ -169,8 +181,111 @@ SCENARIO( "A Set can be reverted to an earlier state", "[Set]" ) {
 		}
 	}
 }
+
+SCENARIO( "A Set finds each object by name after being copied or changed", "[Set]" ) {
+	GIVEN( "a Set<T> with many objects" ) {
+		auto original = Set<T>{};
+		const auto names = MakeNames(200);
+		for(int i = 0; i < static_cast<int>(names.size()); ++i)
+			original.Get(names[i])->a = i;
+
+		THEN( "each object is found by its name" ) {
+			bool allFound = true;
+			for(int i = 0; i < static_cast<int>(names.size()); ++i)
+				allFound &= (original.Has(names[i]) && original.Find(names[i])->a == i
+					&& original.find(names[i])->first == names[i] && original.Get(names[i]) == original.Find(names[i]));
+			CHECK( allFound );
+			CHECK( original.size() == static_cast<int>(names.size()) );
+		}
+		THEN( "the objects are iterated over in order of their names" ) {
+			auto it = original.begin();
+			auto next = it;
+			bool isSorted = true;
+			for(++next; next != original.end(); ++it, ++next)
+				isSorted &= (it->first < next->first);
+			CHECK( isSorted );
+		}
+		WHEN( "the Set is copied" ) {
+			auto copy = original;
+			auto assigned = Set<T>{};
+			assigned.Get("other");
+			assigned = original;
+			THEN( "each copy finds its own objects" ) {
+				bool allFound = true;
+				for(const auto &name : names)
+					allFound &= (copy.Find(name) == &copy.find(name)->second && copy.Find(name) != original.Find(name)
+						&& assigned.Find(name) == &assigned.find(name)->second && assigned.Find(name) != copy.Find(name));
+				CHECK( allFound );
+				CHECK_FALSE( assigned.Has("other") );
+			}
+		}
+		WHEN( "the Set is moved" ) {
+			const T *first = original.Find(names.front());
+			auto moved = std::move(original);
+			THEN( "the objects are found in their new owner" ) {
+				CHECK( moved.Find(names.front()) == first );
+				CHECK( moved.size() == static_cast<int>(names.size()) );
+			}
+		}
+		WHEN( "the Set is reverted to one with fewer objects" ) {
+			auto fewer = Set<T>{};
+			for(int i = 0; i < 100; ++i)
+				fewer.Get(names[i])->a = -i;
+			original.Revert(fewer);
+			THEN( "the removed objects can no longer be found" ) {
+				CHECK( original.size() == 100 );
+				CHECK_FALSE( original.Has(names[150]) );
+				CHECK( original.Find(names[150]) == nullptr );
+				CHECK( original.find(names[150]) == original.end() );
+				CHECK( original.Find(names[50])->a == -50 );
+			}
+			AND_WHEN( "a removed object is asked for again" ) {
+				const T *object = original.Get(names[150]);
+				THEN( "it is created anew" ) {
+					CHECK( object->a == 1 );
+					CHECK( original.Find(names[150]) == object );
+					CHECK( original.size() == 101 );
+				}
+			}
+		}
+	}
+}
 // #endregion unit tests
 
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark Set lookups", "[!benchmark][Set]" ) {
+	const auto names = MakeNames(2000);
+	auto set = Set<T>{};
+	std::map<std::string, T> map;
+	for(const auto &name : names)
+	{
+		set.Get(name);
+		map[name];
+	}
+
+	BENCHMARK( "Set::Find" ) {
+		int total = 0;
+		for(const auto &name : names)
+			total += set.Find(name)->a;
+		return total;
+	};
+	BENCHMARK( "std::map::find" ) {
+		int total = 0;
+		for(const auto &name : names)
+			total += map.find(name)->second.a;
+		return total;
+	};
+	BENCHMARK( "Set::Get, filling a new set" ) {
+		auto filled = Set<T>{};
+		for(const auto &name : names)
+			filled.Get(name);
+		return filled.size();
+	};
+}
+#endif
+// #endregion benchmarks
+
 
 
 } // test namespace
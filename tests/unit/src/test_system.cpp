@@ -0,0 +1,164 @@
+/* test_system.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/System.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// ... and any other headers needed to create systems that trade.
+#include "../../../source/Planet.h"
+#include "../../../source/Random.h"
+#include "../../../source/Set.h"
+#include "../../../source/SystemGrid.h"
+#include "../../../source/Trade.h"
+
+// ... and any system includes needed for the test file.
+#include <cmath>
+#include <map>
+#include <string>
+
+namespace { // test namespace
+
+// #region mock data
+// The price of a commodity with the given base price and supply.
+int Price(int base, double supply)
+{
+	return base + static_cast<int>(-100. * std::erf(supply / 20000.));
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Stepping the economy of a few linked systems", "[System][Economy]" ) {
+	Trade trade;
+	trade.Load(AsDataNode("trade\n\tcommodity Food 100 600\n\tcommodity Metal 300 800"
+		"\n\tcommodity Plastic 200 500"));
+
+	// A trades Food and Metal, and is linked to both of the other systems.
+	// B only trades Food, and C trades nothing at all.
+	Set<System> systems;
+	Set<Planet> planets;
+	System &a = *systems.Get("A");
+	System &b = *systems.Get("B");
+	System &c = *systems.Get("C");
+	a.Load(AsDataNode("system A\n\tpos 0 0\n\ttrade Food 300\n\ttrade Metal 500"), planets);
+	b.Load(AsDataNode("system B\n\tpos 50 0\n\ttrade Food 200"), planets);
+	c.Load(AsDataNode("system C\n\tpos 0 50"), planets);
+	a.Link(&b);
+	a.Link(&c);
+	const SystemGrid grid(systems, System::DEFAULT_NEIGHBOR_DISTANCE);
+	for(auto &it : systems)
+	{
+		it.second.UpdateSystem(grid, {System::DEFAULT_NEIGHBOR_DISTANCE});
+		it.second.UpdateTrade(trade.Commodities());
+	}
+
+	GIVEN( "a supply of the goods each system trades" ) {
+		a.SetSupply("Food", 10000.);
+		a.SetSupply("Metal", -4000.);
+		b.SetSupply("Food", 2000.);
+		b.SetSupply("Metal", 5000.);
+		c.SetSupply("Food", 3000.);
+		THEN( "only traded goods have a supply" ) {
+			CHECK( a.Supply("Food") == 10000. );
+			CHECK( a.Supply("Metal") == -4000. );
+			CHECK( b.Supply("Metal") == 0. );
+			CHECK( c.Supply("Food") == 0. );
+		}
+		THEN( "the price of each good reflects its supply" ) {
+			CHECK( a.Trade("Food") == Price(300, 10000.) );
+			CHECK( a.Trade("Metal") == Price(500, -4000.) );
+			CHECK( a.Trade("Plastic") == 0 );
+			CHECK( b.Trade("Food") == Price(200, 2000.) );
+			CHECK( b.Trade("Metal") == 0 );
+			CHECK( c.Trade("Food") == 0 );
+		}
+
+		WHEN( "a day passes" ) {
+			// Each system draws a new supply of each good it trades, in the
+			// order of the systems and then of the commodities.
+			Random::Seed(42);
+			const double foodA = Random::Normal() * 2000.;
+			const double metalA = Random::Normal() * 2000.;
+			const double foodB = Random::Normal() * 2000.;
+
+			Random::Seed(42);
+			System::StepEconomy(systems, 1);
+
+			THEN( "each system exports a tenth of its supply of each good" ) {
+				CHECK( a.Exports("Food") == Approx(1000.) );
+				CHECK( a.Exports("Metal") == Approx(-400.) );
+				CHECK( b.Exports("Food") == Approx(200.) );
+				CHECK( b.Exports("Metal") == 0. );
+				CHECK( c.Exports("Food") == 0. );
+			}
+			THEN( "each system keeps most of its supply and imports its share of its neighbors' exports" ) {
+				// B only has one link, so A gets all its exports. A has two
+				// links, so B gets half of its exports.
+				CHECK( a.Supply("Food") == Approx(8900. + foodA + 200.) );
+				CHECK( a.Supply("Metal") == Approx(-3560. + metalA) );
+				CHECK( b.Supply("Food") == Approx(1780. + foodB + 500.) );
+			}
+			THEN( "goods that a system does not trade are not imported" ) {
+				CHECK( b.Supply("Metal") == 0. );
+				CHECK( c.Supply("Food") == 0. );
+				CHECK( c.Supply("Metal") == 0. );
+				CHECK( a.Supply("Plastic") == 0. );
+			}
+			THEN( "the prices reflect the new supply" ) {
+				CHECK( a.Trade("Food") == Price(300, a.Supply("Food")) );
+				CHECK( a.Trade("Metal") == Price(500, a.Supply("Metal")) );
+				CHECK( b.Trade("Food") == Price(200, b.Supply("Food")) );
+				CHECK( c.Trade("Food") == 0 );
+			}
+		}
+		WHEN( "several days pass at once" ) {
+			Random::Seed(7);
+			for(int day = 0; day < 3; ++day)
+				System::StepEconomy(systems, 1);
+			std::map<const System *, std::map<std::string, double>> daily;
+			for(const auto &it : systems)
+				for(const char *commodity : {"Food", "Metal"})
+					daily[&it.second][commodity] = it.second.Supply(commodity);
+
+			a.SetSupply("Food", 10000.);
+			a.SetSupply("Metal", -4000.);
+			b.SetSupply("Food", 2000.);
+			Random::Seed(7);
+			System::StepEconomy(systems, 3);
+
+			THEN( "the supply is the same as if each day had passed in turn" ) {
+				for(const auto &it : systems)
+					for(const char *commodity : {"Food", "Metal"})
+						CHECK( it.second.Supply(commodity) == daily[&it.second][commodity] );
+			}
+			THEN( "the prices reflect the final supply" ) {
+				CHECK( a.Trade("Food") == Price(300, a.Supply("Food")) );
+				CHECK( a.Trade("Metal") == Price(500, a.Supply("Metal")) );
+				CHECK( b.Trade("Food") == Price(200, b.Supply("Food")) );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace
@@ -0,0 +1,161 @@
+/* test_systemGrid.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/SystemGrid.h"
+
+// Include a helper for creating well-formed DataNodes.
+#include "datanode-factory.h"
+
+// Include a helper for laying out test data.
+#include "scatter-helpers.h"
+
+// ... and any other headers needed to create systems.
+#include "../../../source/Planet.h"
+#include "../../../source/Point.h"
+#include "../../../source/Set.h"
+#include "../../../source/System.h"
+
+// ... and any system includes needed for the test file.
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Systems scattered over an area centered on the origin. Some of them are
+// inaccessible, and some are never given a name, so they cannot be neighbors.
+void MakeSystems(Set<System> &systems, Set<Planet> &planets, std::size_t count, double area)
+{
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		std::size_t hash = Hash(i);
+		const std::string name = "System " + std::to_string(i);
+		if(hash % 23 == 0)
+		{
+			systems.Get(name);
+			continue;
+		}
+		double x = (hash % 4093) * area / 4093. - area / 2.;
+		double y = ((hash / 4093) % 4091) * area / 4091. - area / 2.;
+		systems.Get(name)->Load(AsDataNode("system \"" + name + "\"\n\tpos "
+			+ std::to_string(x) + " " + std::to_string(y) + (hash % 17 ? "" : "\n\tinaccessible")), planets);
+	}
+}
+
+// Find the systems within a distance of a point by checking every system.
+std::vector<const System *> BruteWithin(const Set<System> &systems, const Point &center, double distance)
+{
+	std::vector<const System *> result;
+	for(const auto &it : systems)
+	{
+		const System &system = it.second;
+		if(!system.Name().empty() && !system.Inaccessible() && system.Position().Distance(center) <= distance)
+			result.push_back(&system);
+	}
+	return result;
+}
+
+std::vector<const System *> Sorted(std::vector<const System *> systems)
+{
+	std::sort(systems.begin(), systems.end());
+	return systems;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Finding the systems near a point", "[SystemGrid]" ) {
+	Set<System> systems;
+	Set<Planet> planets;
+	MakeSystems(systems, planets, 2000, 5000.);
+	GIVEN( "a grid of systems" ) {
+		const SystemGrid grid(systems, 100.);
+		THEN( "the systems within a distance are the same as when checking every system" ) {
+			bool allMatch = true;
+			std::size_t found = 0;
+			for(std::size_t i = 0; i < 500; ++i)
+			{
+				std::size_t hash = (i + 17) * 2246822519u;
+				Point center((hash % 6007) - 3003., ((hash / 6007) % 6011) - 3005.);
+				double distance = (hash % 13) * 40.;
+				std::vector<const System *> within = grid.Within(center, distance);
+				allMatch &= (Sorted(within) == Sorted(BruteWithin(systems, center, distance)));
+				found += within.size();
+			}
+			CHECK( allMatch );
+			// Make sure that the comparison was not trivial.
+			CHECK( found > 500 );
+		}
+		THEN( "a system is within any distance of itself" ) {
+			const System *system = systems.Get("System 1");
+			std::vector<const System *> within = grid.Within(system->Position(), 0.);
+			CHECK( std::count(within.begin(), within.end(), system) == 1 );
+		}
+		THEN( "systems that cannot be neighbors are never found" ) {
+			std::vector<const System *> within = grid.Within(Point(), 10000.);
+			CHECK( within.size() == BruteWithin(systems, Point(), 10000.).size() );
+			CHECK( static_cast<int>(within.size()) < systems.size() );
+		}
+	}
+	GIVEN( "a grid with cells larger than the whole area" ) {
+		const SystemGrid grid(systems, 100000.);
+		THEN( "the same systems are found" ) {
+			CHECK( Sorted(grid.Within(Point(100., -200.), 300.))
+				== Sorted(BruteWithin(systems, Point(100., -200.), 300.)) );
+		}
+	}
+}
+// #endregion unit tests
+
+// #region benchmarks
+#ifdef CATCH_CONFIG_ENABLE_BENCHMARKING
+TEST_CASE( "Benchmark finding every system's neighbors", "[!benchmark][SystemGrid]" ) {
+	for(std::size_t count : {1000, 10000, 40000})
+	{
+		// Keep the density of systems about the same as in the shipped map.
+		Set<System> systems;
+		Set<Planet> planets;
+		MakeSystems(systems, planets, count, 60. * std::sqrt(count));
+
+		BENCHMARK( "Build a grid and find neighbors of " + std::to_string(count) + " systems" ) {
+			const SystemGrid grid(systems, 100.);
+			std::size_t total = 0;
+			for(const auto &it : systems)
+				total += grid.Within(it.second.Position(), 100.).size();
+			return total;
+		};
+		if(count > 1000)
+			continue;
+		BENCHMARK( "Check every pair of " + std::to_string(count) + " systems" ) {
+			std::size_t total = 0;
+			for(const auto &it : systems)
+				total += BruteWithin(systems, it.second.Position(), 100.).size();
+			return total;
+		};
+	}
+}
+#endif
+// #endregion benchmarks
+
+
+
+} // test namespace
@@ -0,0 +1,184 @@
+/* test_workerPool.cpp
+Copyright (c) 2026 by Endless Sky contributors
+
+Endless Sky is free software: you can redistribute it and/or modify it under the
+terms of the GNU General Public License as published by the Free Software
+Foundation, either version 3 of the License, or (at your option) any later version.
+
+Endless Sky is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR A
+PARTICULAR PURPOSE. See the GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License along with
+this program. If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "es-test.hpp"
+
+// Include only the tested class's header.
+#include "../../../source/WorkerPool.h"
+
+// Include a helper for seeding the work.
+#include "../../../source/Random.h"
+
+// ... and any other headers needed to step some ships.
+#include "../../../source/Angle.h"
+#include "../../../source/Point.h"
+#include "../../../source/Ship.h"
+
+// ... and any system includes needed for the test file.
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace { // test namespace
+
+// #region mock data
+// Run a batch of seeded work with the given number of threads, and return the
+// numbers each item drew. Each item draws an odd number of normally distributed
+// values, so that the distribution is left holding a cached value.
+std::vector<std::vector<double>> SeededDraws(unsigned threads, std::size_t count)
+{
+	WorkerPool pool(threads);
+	std::vector<std::vector<double>> draws(count);
+	Random::Seed(12345);
+	pool.RunSeeded(count, [&draws](std::size_t i)
+	{
+		for(std::size_t j = 0; j < 1 + 2 * (i % 3); ++j)
+			draws[i].push_back(Random::Normal());
+	});
+	// The number drawn after the batch is also part of the result.
+	draws.push_back({Random::Normal()});
+	return draws;
+}
+
+// The state of a ship that a step of the simulation may change.
+struct ShipState {
+	Point position;
+	Point velocity;
+	double facing;
+
+	bool operator==(const ShipState &other) const
+	{
+		return position.X() == other.position.X() && position.Y() == other.position.Y()
+			&& velocity.X() == other.velocity.X() && velocity.Y() == other.velocity.Y() && facing == other.facing;
+	}
+};
+
+// Step the given number of ships with a pool of the given number of threads,
+// the way the engine does when parallel simulation is turned on (several
+// threads) or off (one thread). Each ship drifts and turns by random amounts,
+// some of them more than once. Return the state of each ship afterward.
+std::vector<ShipState> SeededStep(unsigned threads, std::size_t count)
+{
+	std::vector<std::shared_ptr<Ship>> ships;
+	for(std::size_t i = 0; i < count; ++i)
+	{
+		ships.push_back(std::make_shared<Ship>());
+		ships.back()->Place(Point(i, 0.), Point(), Angle(), false);
+	}
+
+	WorkerPool pool(threads);
+	Random::Seed(67890);
+	for(int step = 0; step < 3; ++step)
+		pool.RunSeeded(count, [&ships](std::size_t i)
+		{
+			Ship &ship = *ships[i];
+			Point velocity = ship.Velocity();
+			for(std::size_t j = 0; j <= Random::Int(3); ++j)
+				velocity += Point(Random::Normal(), Random::Normal());
+			ship.Place(ship.Position() + velocity, velocity, ship.Facing() + Angle(Random::Real() * 10.), false);
+		});
+
+	std::vector<ShipState> states;
+	for(const auto &ship : ships)
+		states.push_back({ship->Position(), ship->Velocity(), ship->Facing().Degrees()});
+	return states;
+}
+// #endregion mock data
+
+
+
+// #region unit tests
+SCENARIO( "Creating a WorkerPool", "[WorkerPool]" ) {
+	GIVEN( "a requested number of threads" ) {
+		WorkerPool pool(3);
+		THEN( "the pool has that many threads, including the caller" ) {
+			CHECK( pool.Size() == 3 );
+		}
+	}
+	GIVEN( "no requested number of threads" ) {
+		WorkerPool pool;
+		THEN( "the pool has at least one thread" ) {
+			CHECK( pool.Size() >= 1 );
+		}
+	}
+}
+
+SCENARIO( "Running work on a WorkerPool", "[WorkerPool]" ) {
+	GIVEN( "a pool with several threads" ) {
+		WorkerPool pool(4);
+		WHEN( "a batch of work is run" ) {
+			std::vector<int> calls(1000, 0);
+			pool.Run(calls.size(), [&calls](std::size_t i) { ++calls[i]; });
+			THEN( "every item is processed exactly once" ) {
+				for(int count : calls)
+					CHECK( count == 1 );
+			}
+		}
+		WHEN( "several batches are run in a row" ) {
+			std::vector<std::size_t> results(100, 0);
+			for(std::size_t batch = 1; batch <= 10; ++batch)
+				pool.Run(results.size(), [&results, batch](std::size_t i) { results[i] += batch * i; });
+			THEN( "each batch completes before the next begins" ) {
+				for(std::size_t i = 0; i < results.size(); ++i)
+					CHECK( results[i] == 55 * i );
+			}
+		}
+		WHEN( "an empty batch is run" ) {
+			bool called = false;
+			pool.Run(0, [&called](std::size_t) { called = true; });
+			THEN( "nothing is called" ) {
+				CHECK_FALSE( called );
+			}
+		}
+	}
+	// Seeding each item only makes a difference if every thread has its own
+	// random number generator.
+	if(Random::IsThreadLocal())
+		GIVEN( "seeded work that draws random numbers" ) {
+			WHEN( "the work is run with one thread and with several threads" ) {
+				auto serial = SeededDraws(1, 200);
+				auto parallel = SeededDraws(4, 200);
+				THEN( "every item draws the same numbers" ) {
+					CHECK( serial == parallel );
+				}
+			}
+		}
+	if(Random::IsThreadLocal())
+		GIVEN( "a seeded step of the simulation" ) {
+			WHEN( "the step is run with parallel simulation turned off and turned on" ) {
+				auto serial = SeededStep(1, 100);
+				auto parallel = SeededStep(4, 100);
+				THEN( "every ship ends up in the same state" ) {
+					REQUIRE( serial.size() == parallel.size() );
+					CHECK( serial == parallel );
+				}
+			}
+		}
+	GIVEN( "a pool with only the calling thread" ) {
+		WorkerPool pool(1);
+		WHEN( "a batch of work is run" ) {
+			std::vector<std::size_t> order;
+			pool.Run(5, [&order](std::size_t i) { order.push_back(i); });
+			THEN( "the items are processed in order" ) {
+				CHECK( order == std::vector<std::size_t>{0, 1, 2, 3, 4} );
+			}
+		}
+	}
+}
+// #endregion unit tests
+
+
+
+} // test namespace